@@ -0,0 +1,90 @@
+#ifndef ZMQ_SIMPLE_BENCH_HISTOGRAM_HPP
+#define ZMQ_SIMPLE_BENCH_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace bench {
+
+// HdrHistogram 风格的对数-线性直方图: 小于 2^kSubBits 的值精确记录，之后每个 2 的幂区间
+// 等分为 2^kSubBits 个桶，相对误差小于 1/128。记录为 O(1)，直方图可直接合并
+class Histogram {
+public:
+    static const unsigned kSubBits = 7;
+    static const uint64_t kSubCount = uint64_t(1) << kSubBits;
+
+    Histogram() : counts_((65 - kSubBits) * kSubCount, 0), count_(0), sum_(0), min_(UINT64_MAX), max_(0) {}
+
+    void record(uint64_t value) {
+        ++counts_[index_of(value)];
+        ++count_;
+        sum_ += static_cast<double>(value);
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    void merge(const Histogram& other) {
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        count_ += other.count_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ == 0 ? 0 : min_; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ == 0 ? 0.0 : sum_ / static_cast<double>(count_); }
+
+    // 不小于 p% 样本的最小值 (取所在桶的上界，不超过最大值)
+    uint64_t percentile(double p) const {
+        if (count_ == 0) {
+            return 0;
+        }
+        const uint64_t target = std::max<uint64_t>(
+            1, static_cast<uint64_t>(std::ceil(std::min(100.0, std::max(0.0, p)) / 100.0 * count_)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= target) {
+                return std::min(upper_bound(i), max_);
+            }
+        }
+        return max_;
+    }
+
+private:
+    static size_t index_of(uint64_t value) {
+        if (value < kSubCount) {
+            return static_cast<size_t>(value);
+        }
+        const unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(value));
+        const uint64_t sub = value >> (msb - kSubBits); // [kSubCount, 2 * kSubCount)
+        return static_cast<size_t>((msb - kSubBits + 1) * kSubCount + (sub - kSubCount));
+    }
+
+    static uint64_t upper_bound(size_t index) {
+        if (index < kSubCount) {
+            return index;
+        }
+        const unsigned shift = static_cast<unsigned>(index / kSubCount) - 1;
+        const uint64_t sub = index % kSubCount + kSubCount;
+        const uint64_t next = (sub + 1) << shift;
+        return next == 0 ? UINT64_MAX : next - 1;
+    }
+
+    std::vector<uint64_t> counts_;
+    uint64_t count_;
+    double sum_;
+    uint64_t min_;
+    uint64_t max_;
+};
+
+} // namespace bench
+
+#endif // ZMQ_SIMPLE_BENCH_HISTOGRAM_HPP
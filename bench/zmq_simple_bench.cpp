@@ -0,0 +1,447 @@
+/*
+ * 吞吐与单向时延基准
+ *
+ * 对每种传输方式 (INPROC / IPC)、订阅端数量 (1, 2, 4 ... N) 和消息大小 (16B ~ 16MB，按 4 倍递增):
+ *   1. 吞吐: 发布端尽快发送，统计各订阅端实际收到的条数 (超过高水位的消息被 ZeroMQ 丢弃，计入丢失率)，
+ *      同时记录负载下的时延
+ *   2. 时延: 逐条发送，所有订阅端收到上一条后再发下一条，测得无排队时的单向时延
+ * 订阅端为同一进程内的线程，负载前 16 字节为发送时刻 (steady_clock) 与序号。
+ *
+ * 用法: zmq_simple_bench [--transport inproc|ipc|all] [--min-size 16] [--max-size 16M]
+ *                        [--subscribers 4] [--messages 20000] [--latency-samples 2000]
+ *                        [--budget 256M] [--json results.json | --json -]
+ */
+
+#include "../include/zmq_simple.hpp"
+#include "histogram.hpp"
+#include <nlohmann/json.hpp>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+    std::vector<zmq_simple::Transport> transports = {zmq_simple::Transport::INPROC, zmq_simple::Transport::IPC};
+    size_t min_size = 16;
+    size_t max_size = 16 * 1024 * 1024;
+    int max_subscribers = 4;
+    size_t messages = 20000;        // 吞吐阶段每轮的条数上限
+    size_t latency_samples = 2000;  // 时延阶段每轮的条数上限
+    size_t budget = 256 * 1024 * 1024; // 每个阶段发送的总字节数上限，限制大消息的轮次与内存占用
+    std::string json_path;
+};
+
+const size_t kStampSize = 16;
+const char* const kWarmup = "w";
+const char* const kThroughput = "t";
+const char* const kLatency = "l";
+const char* const kEnd = "e";
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+void stamp(std::vector<uint8_t>& buffer, uint64_t sequence) {
+    const uint64_t ts = now_ns();
+    std::memcpy(buffer.data(), &ts, sizeof(ts));
+    std::memcpy(buffer.data() + sizeof(ts), &sequence, sizeof(sequence));
+}
+
+// 订阅端线程的状态，直方图只由订阅端线程写入，join 之后再读取
+struct SubscriberState {
+    std::atomic<bool> ready{false};
+    std::atomic<bool> warmed{false};
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> throughput_received{0};
+    std::atomic<uint64_t> last_receive_ns{0};
+    std::atomic<int64_t> latency_acked{-1};
+    bench::Histogram loaded;
+    bench::Histogram paced;
+    std::string error;
+};
+
+void subscriber_main(const std::string& endpoint, zmq_simple::Transport transport, zmq_simple::Context* context,
+                     SubscriberState& state) {
+    try {
+        std::unique_ptr<zmq_simple::Subscriber> sub(
+            context != nullptr ? new zmq_simple::Subscriber(endpoint, transport, *context)
+                               : new zmq_simple::Subscriber(endpoint, transport));
+        sub->subscribe("");
+        state.ready = true;
+
+        zmq_simple::Message message;
+        while (true) {
+            if (!sub->receive(message, 200)) {
+                continue;
+            }
+            const uint64_t received = now_ns();
+            const std::string& topic = message.topic();
+            if (topic == kEnd) {
+                break;
+            }
+            if (topic == kWarmup) {
+                state.warmed = true;
+                continue;
+            }
+            if (message.size() < kStampSize) {
+                continue;
+            }
+            uint64_t sent = 0;
+            uint64_t sequence = 0;
+            std::memcpy(&sent, message.data(), sizeof(sent));
+            std::memcpy(&sequence, message.data() + sizeof(sent), sizeof(sequence));
+            const uint64_t latency = received > sent ? received - sent : 0;
+            if (topic == kThroughput) {
+                state.loaded.record(latency);
+                ++state.throughput_received;
+                state.last_receive_ns = received;
+            } else if (topic == kLatency) {
+                state.paced.record(latency);
+                state.latency_acked = static_cast<int64_t>(sequence);
+            }
+        }
+    } catch (const std::exception& e) {
+        state.error = e.what();
+        state.ready = true;
+    }
+    state.done = true;
+}
+
+template <typename Predicate>
+bool wait_until(Predicate predicate, std::chrono::milliseconds timeout) {
+    const auto deadline = Clock::now() + timeout;
+    while (!predicate()) {
+        if (Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+nlohmann::json latency_json(const bench::Histogram& h) {
+    return {
+        {"samples", h.count()},
+        {"mean", h.mean() / 1000.0},
+        {"p50", h.percentile(50.0) / 1000.0},
+        {"p99", h.percentile(99.0) / 1000.0},
+        {"p999", h.percentile(99.9) / 1000.0},
+        {"max", h.max() / 1000.0},
+    };
+}
+
+std::string transport_name(zmq_simple::Transport transport) {
+    return transport == zmq_simple::Transport::IPC ? "ipc" : "inproc";
+}
+
+nlohmann::json run(const Config& config, zmq_simple::Transport transport, int subscribers, size_t size) {
+    static int run_id = 0;
+    const std::string endpoint = "zmq_simple_bench_" + std::to_string(getpid()) + "_" + std::to_string(++run_id);
+
+    // INPROC 要求同一个 Context；IPC 各用各的，与多进程部署一致
+    std::unique_ptr<zmq_simple::Context> context;
+    if (transport == zmq_simple::Transport::INPROC) {
+        context.reset(new zmq_simple::Context());
+    }
+    std::unique_ptr<zmq_simple::Publisher> pub(
+        context ? new zmq_simple::Publisher(endpoint, transport, *context) : new zmq_simple::Publisher(endpoint, transport));
+
+    std::vector<std::unique_ptr<SubscriberState>> states;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < subscribers; ++i) {
+        states.emplace_back(new SubscriberState());
+        threads.emplace_back(subscriber_main, endpoint, transport, context.get(), std::ref(*states.back()));
+    }
+    auto all = [&states](bool (*check)(const SubscriberState&)) {
+        for (const auto& s : states) {
+            if (!check(*s)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    auto finish = [&]() {
+        // 结束消息也可能被丢弃，重复发送直到所有订阅端退出
+        while (!all([](const SubscriberState& s) { return s.done.load(); })) {
+            pub->publish(kEnd, "", 0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    };
+
+    wait_until([&] { return all([](const SubscriberState& s) { return s.ready.load(); }); },
+               std::chrono::seconds(5));
+    for (const auto& s : states) {
+        if (!s->error.empty()) {
+            finish();
+            throw std::runtime_error("subscriber failed: " + s->error);
+        }
+    }
+
+    // 订阅生效前发布的消息会被丢弃 (slow joiner)，持续发送预热消息直到所有订阅端收到
+    std::vector<uint8_t> buffer(std::max(size, kStampSize), 0xA5);
+    const bool warmed = wait_until(
+        [&] {
+            pub->publish(kWarmup, "", 0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return all([](const SubscriberState& s) { return s.warmed.load(); });
+        },
+        std::chrono::seconds(5));
+    if (!warmed) {
+        finish();
+        throw std::runtime_error("subscribers did not connect within 5s");
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // 吞吐
+    const size_t messages = std::max<size_t>(10, std::min(config.messages, config.budget / buffer.size()));
+    const uint64_t start = now_ns();
+    size_t sent = 0;
+    for (size_t i = 0; i < messages; ++i) {
+        stamp(buffer, i);
+        sent += pub->publish(kThroughput, buffer.data(), buffer.size()) ? 1 : 0;
+    }
+    const uint64_t send_end = now_ns();
+
+    // 等到所有订阅端收齐，或 500ms 内没有新消息 (其余已被丢弃)
+    uint64_t total = 0;
+    while (true) {
+        uint64_t current = 0;
+        for (const auto& s : states) {
+            current += s->throughput_received;
+        }
+        if (current == sent * states.size()) {
+            total = current;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        uint64_t after = 0;
+        for (const auto& s : states) {
+            after += s->throughput_received;
+        }
+        if (after == current) {
+            total = after;
+            break;
+        }
+    }
+    uint64_t last = send_end;
+    for (const auto& s : states) {
+        last = std::max<uint64_t>(last, s->last_receive_ns);
+    }
+
+    // 单向时延: 所有订阅端确认上一条后再发下一条，超时的样本视为丢失
+    const size_t samples = std::max<size_t>(10, std::min(config.latency_samples, config.budget / buffer.size()));
+    size_t lost = 0;
+    for (size_t i = 0; i < samples; ++i) {
+        stamp(buffer, i);
+        pub->publish(kLatency, buffer.data(), buffer.size());
+        const int64_t seq = static_cast<int64_t>(i);
+        if (!wait_until(
+                [&] {
+                    for (const auto& s : states) {
+                        if (s->latency_acked < seq) {
+                            return false;
+                        }
+                    }
+                    return true;
+                },
+                std::chrono::seconds(1))) {
+            ++lost;
+        }
+    }
+
+    finish();
+
+    bench::Histogram loaded;
+    bench::Histogram paced;
+    nlohmann::json per_subscriber = nlohmann::json::array();
+    for (const auto& s : states) {
+        loaded.merge(s->loaded);
+        paced.merge(s->paced);
+        per_subscriber.push_back(s->throughput_received.load());
+    }
+
+    const double elapsed = std::max<uint64_t>(1, last - start) / 1e9;
+    const double send_elapsed = std::max<uint64_t>(1, send_end - start) / 1e9;
+    const double delivered_rate = total / elapsed;
+    return {
+        {"transport", transport_name(transport)},
+        {"subscribers", subscribers},
+        {"message_size", size},
+        {"throughput",
+         {
+             {"sent", sent},
+             {"received", per_subscriber},
+             {"send_rate", sent / send_elapsed},
+             {"delivered_rate", delivered_rate},
+             {"per_subscriber_rate", delivered_rate / subscribers},
+             {"megabytes_per_sec", delivered_rate * size / 1e6},
+             {"loss_ratio", sent == 0 ? 0.0 : 1.0 - static_cast<double>(total) / (sent * subscribers)},
+         }},
+        {"loaded_latency_us", latency_json(loaded)},
+        {"latency_us", latency_json(paced)},
+        {"latency_lost", lost},
+    };
+}
+
+size_t parse_size(const std::string& text) {
+    size_t pos = 0;
+    const unsigned long long value = std::stoull(text, &pos);
+    const std::string suffix = text.substr(pos);
+    if (suffix.empty() || suffix == "B") {
+        return value;
+    }
+    if (suffix == "K" || suffix == "KB") {
+        return value * 1024;
+    }
+    if (suffix == "M" || suffix == "MB") {
+        return value * 1024 * 1024;
+    }
+    throw std::invalid_argument("bad size: " + text);
+}
+
+Config parse_args(int argc, char* argv[]) {
+    Config config;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            std::cout << "usage: zmq_simple_bench [--transport inproc|ipc|all] [--min-size 16] [--max-size 16M]\n"
+                         "                        [--subscribers 4] [--messages 20000] [--latency-samples 2000]\n"
+                         "                        [--budget 256M] [--json FILE|-]\n";
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("missing value for " + arg);
+        }
+        const std::string value = argv[++i];
+        if (arg == "--transport") {
+            if (value == "inproc") {
+                config.transports = {zmq_simple::Transport::INPROC};
+            } else if (value == "ipc") {
+                config.transports = {zmq_simple::Transport::IPC};
+            } else if (value != "all") {
+                throw std::invalid_argument("unknown transport: " + value);
+            }
+        } else if (arg == "--min-size") {
+            config.min_size = std::max(kStampSize, parse_size(value));
+        } else if (arg == "--max-size") {
+            config.max_size = parse_size(value);
+        } else if (arg == "--subscribers") {
+            config.max_subscribers = std::max(1, std::stoi(value));
+        } else if (arg == "--messages") {
+            config.messages = std::stoull(value);
+        } else if (arg == "--latency-samples") {
+            config.latency_samples = std::stoull(value);
+        } else if (arg == "--budget") {
+            config.budget = parse_size(value);
+        } else if (arg == "--json") {
+            config.json_path = value;
+        } else {
+            throw std::invalid_argument("unknown option: " + arg);
+        }
+    }
+    return config;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    try {
+        config = parse_args(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+
+    // IPC 端点所在目录
+    mkdir("/tmp/docker_share", 0777);
+
+    std::vector<int> subscriber_counts;
+    for (int n = 1; n < config.max_subscribers; n *= 2) {
+        subscriber_counts.push_back(n);
+    }
+    subscriber_counts.push_back(config.max_subscribers);
+
+    // JSON 写到标准输出时表格改写到标准错误
+    std::ostream& table = config.json_path == "-" ? std::cerr : std::cout;
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-7s %4s %9s %12s %10s %7s %9s %9s %9s %9s %10s\n", "trans", "subs", "size",
+                  "msg/s/sub", "MB/s", "loss%", "p50(us)", "p99(us)", "p99.9(us)", "max(us)", "load99(us)");
+    table << line;
+
+    nlohmann::json results = nlohmann::json::array();
+    for (zmq_simple::Transport transport : config.transports) {
+        for (int subscribers : subscriber_counts) {
+            for (size_t size = config.min_size; size <= config.max_size; size *= 4) {
+                nlohmann::json result;
+                try {
+                    result = run(config, transport, subscribers, size);
+                } catch (const std::exception& e) {
+                    std::cerr << transport_name(transport) << " subs=" << subscribers << " size=" << size
+                              << ": " << e.what() << std::endl;
+                    continue;
+                }
+                const nlohmann::json& tp = result["throughput"];
+                const nlohmann::json& lat = result["latency_us"];
+                std::snprintf(line, sizeof(line), "%-7s %4d %9zu %12.0f %10.1f %7.2f %9.1f %9.1f %9.1f %9.1f %10.1f\n",
+                              transport_name(transport).c_str(), subscribers, size,
+                              tp["per_subscriber_rate"].get<double>(), tp["megabytes_per_sec"].get<double>(),
+                              tp["loss_ratio"].get<double>() * 100.0, lat["p50"].get<double>(),
+                              lat["p99"].get<double>(), lat["p999"].get<double>(), lat["max"].get<double>(),
+                              result["loaded_latency_us"]["p99"].get<double>());
+                table << line << std::flush;
+                results.push_back(std::move(result));
+            }
+        }
+    }
+
+    if (!config.json_path.empty()) {
+        nlohmann::json transports = nlohmann::json::array();
+        for (zmq_simple::Transport transport : config.transports) {
+            transports.push_back(transport_name(transport));
+        }
+        const nlohmann::json doc = {
+            {"benchmark", "zmq_simple_bench"},
+            {"config",
+             {
+                 {"transports", transports},
+                 {"min_size", config.min_size},
+                 {"max_size", config.max_size},
+                 {"max_subscribers", config.max_subscribers},
+                 {"messages", config.messages},
+                 {"latency_samples", config.latency_samples},
+                 {"budget", config.budget},
+             }},
+            {"results", results},
+        };
+        if (config.json_path == "-") {
+            std::cout << doc.dump(2) << std::endl;
+        } else {
+            std::ofstream out(config.json_path);
+            out << doc.dump(2) << std::endl;
+            if (!out) {
+                std::cerr << "failed to write " << config.json_path << std::endl;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
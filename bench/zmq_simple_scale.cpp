@@ -0,0 +1,614 @@
+/*
+ * 多进程扩展性基准
+ *
+ * 每个发布端、订阅端都是 fork 出来的独立进程，经 /tmp/docker_share 下的 IPC 端点通信，
+ * 对应生产环境的部署方式。拓扑:
+ *   fanout  1 个发布端 → N 个订阅端
+ *   fanin   N 个发布端 → 1 个订阅端
+ *   mesh    N 个发布端 → N 个订阅端 (每个订阅端连接所有发布端)
+ * 订阅端为每个发布端创建一个 Subscriber，用 Poller 同时等待。默认每个 Subscriber 各有一个
+ * Context (即各自的 I/O 线程)，--shared-context 改为进程内共用一个 Context，用于对比。
+ *
+ * 输出聚合吞吐、每个订阅端的时延、每条消息的 CPU 时间 (用户态 + 内核态，含 ZeroMQ I/O 线程)
+ * 以及每个进程的线程数。
+ *
+ * 用法: zmq_simple_scale [--topology fanout|fanin|mesh|all] [--processes 8] [--size 256]
+ *                        [--messages 100000] [--rate 0] [--shared-context] [--json FILE|-]
+ */
+
+#include "../include/zmq_simple.hpp"
+#include "histogram.hpp"
+#include <nlohmann/json.hpp>
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+    std::vector<std::string> topologies = {"fanout", "fanin", "mesh"};
+    int max_processes = 8;
+    size_t size = 256;
+    uint64_t messages = 100000; // 每个发布端发送的条数
+    uint64_t rate = 0;          // 每个发布端每秒发送的条数，0 为不限速
+    bool shared_context = false;
+    int timeout_ms = 10000;     // 等待子进程就绪或结果的上限
+    std::string json_path;
+};
+
+// 负载前 24 字节: 发送时刻 (steady_clock 在同一主机的进程间可比)、序号、发布端编号
+const size_t kStampSize = 24;
+const char* const kWarmup = "w";
+const char* const kData = "t";
+const char* const kEnd = "e";
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+// 本进程所有线程 (包括 ZeroMQ I/O 线程) 的 CPU 时间
+uint64_t cpu_ns() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (static_cast<uint64_t>(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec) * 1000000000ull +
+           (static_cast<uint64_t>(usage.ru_utime.tv_usec) + usage.ru_stime.tv_usec) * 1000ull;
+}
+
+int thread_count() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 8, "Threads:") == 0) {
+            return std::stoi(line.substr(8));
+        }
+    }
+    return 0;
+}
+
+void write_line(int fd, const std::string& text) {
+    const std::string line = text + "\n";
+    size_t written = 0;
+    while (written < line.size()) {
+        const ssize_t n = write(fd, line.data() + written, line.size() - written);
+        if (n <= 0) {
+            return;
+        }
+        written += static_cast<size_t>(n);
+    }
+}
+
+// 从管道读一行，超时或对端关闭返回 false
+bool read_line(int fd, std::string& line, int timeout_ms) {
+    line.clear();
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+        struct pollfd item = {fd, POLLIN, 0};
+        if (left <= 0 || poll(&item, 1, static_cast<int>(left)) <= 0) {
+            return false;
+        }
+        char c;
+        if (read(fd, &c, 1) != 1) {
+            return false;
+        }
+        if (c == '\n') {
+            return true;
+        }
+        line.push_back(c);
+    }
+}
+
+// 父进程发给发布端的命令，超时返回 0
+char read_command(int fd, int timeout_ms) {
+    struct pollfd item = {fd, POLLIN, 0};
+    char c = 0;
+    if (poll(&item, 1, timeout_ms) > 0 && read(fd, &c, 1) != 1) {
+        c = 'q'; // 父进程已退出
+    }
+    return c;
+}
+
+std::string endpoint_name(int run, int publisher) {
+    return "zmq_simple_scale_" + std::to_string(getppid()) + "_" + std::to_string(run) + "_" + std::to_string(publisher);
+}
+
+nlohmann::json publisher_main(const Config& config, int run, int id, int command_fd) {
+    zmq_simple::Publisher pub(endpoint_name(run, id), zmq_simple::Transport::IPC);
+    std::vector<uint8_t> buffer(config.size, 0xA5);
+    const uint64_t publisher_id = static_cast<uint64_t>(id);
+    std::memcpy(buffer.data() + 16, &publisher_id, sizeof(publisher_id));
+
+    // 订阅端全部就绪 (收到每个发布端的预热消息) 后父进程发出 'g'
+    char command = 0;
+    while (command != 'g') {
+        pub.publish(kWarmup, buffer.data(), buffer.size());
+        command = read_command(command_fd, 1);
+        if (command == 'q') {
+            return {{"role", "publisher"}, {"id", id}, {"error", "aborted before start"}};
+        }
+    }
+
+    const uint64_t cpu_start = cpu_ns();
+    const uint64_t start = now_ns();
+    uint64_t sent = 0;
+    for (uint64_t i = 0; i < config.messages; ++i) {
+        if (config.rate != 0) {
+            const uint64_t due = start + i * 1000000000ull / config.rate;
+            uint64_t now = now_ns();
+            while (now < due) {
+                if (due - now > 100000) {
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(due - now - 50000));
+                }
+                now = now_ns();
+            }
+        }
+        const uint64_t ts = now_ns();
+        std::memcpy(buffer.data(), &ts, sizeof(ts));
+        std::memcpy(buffer.data() + 8, &i, sizeof(i));
+        sent += pub.publish(kData, buffer.data(), buffer.size()) ? 1 : 0;
+    }
+    const uint64_t elapsed = now_ns() - start;
+    const uint64_t cpu = cpu_ns() - cpu_start;
+
+    // 结束标记可能因高水位被丢弃，重复发送直到父进程收齐订阅端结果后发出 'q'
+    while (command != 'q') {
+        pub.publish(kEnd, buffer.data(), buffer.size());
+        command = read_command(command_fd, 10);
+    }
+    return {
+        {"role", "publisher"},
+        {"id", id},
+        {"sent", sent},
+        {"elapsed_s", elapsed / 1e9},
+        {"send_rate", sent / std::max(1e-9, elapsed / 1e9)},
+        {"cpu_ns", cpu},
+        {"threads", thread_count()},
+    };
+}
+
+nlohmann::json subscriber_main(const Config& config, int run, int id, int publishers, int result_fd) {
+    std::unique_ptr<zmq_simple::Context> context;
+    if (config.shared_context) {
+        context.reset(new zmq_simple::Context());
+    }
+    std::vector<std::unique_ptr<zmq_simple::Subscriber>> subs;
+    zmq_simple::Poller poller;
+    for (int p = 0; p < publishers; ++p) {
+        const std::string endpoint = endpoint_name(run, p);
+        subs.emplace_back(context ? new zmq_simple::Subscriber(endpoint, zmq_simple::Transport::IPC, *context)
+                                  : new zmq_simple::Subscriber(endpoint, zmq_simple::Transport::IPC));
+        subs.back()->subscribe("");
+        poller.add(*subs.back());
+    }
+
+    std::vector<bool> warmed(publishers, false);
+    std::vector<bool> ended(publishers, false);
+    std::vector<uint64_t> received(publishers, 0);
+    int warmed_count = 0;
+    int ended_count = 0;
+    bool reported_ready = false;
+    bench::Histogram latency;
+    uint64_t first = 0;
+    uint64_t last = 0;
+    uint64_t cpu_start = 0;
+    uint64_t idle_since = now_ns();
+
+    std::vector<size_t> ready;
+    zmq_simple::Message message;
+    while (ended_count < publishers) {
+        if (!poller.wait(ready, 100)) {
+            // 发布端被高水位丢掉的结束标记会重发；长时间无消息说明发布端异常
+            if (reported_ready && now_ns() - idle_since > static_cast<uint64_t>(config.timeout_ms) * 1000000ull) {
+                break;
+            }
+            continue;
+        }
+        for (size_t index : ready) {
+            while (poller.at(index).receive(message, 0)) {
+                const uint64_t received_at = now_ns();
+                idle_since = received_at;
+                if (message.size() < kStampSize) {
+                    continue;
+                }
+                uint64_t sent_at = 0;
+                uint64_t publisher = 0;
+                std::memcpy(&sent_at, message.data(), sizeof(sent_at));
+                std::memcpy(&publisher, message.data() + 16, sizeof(publisher));
+                if (publisher >= static_cast<uint64_t>(publishers)) {
+                    continue;
+                }
+                const std::string& topic = message.topic();
+                if (topic == kData) {
+                    if (first == 0) {
+                        first = received_at;
+                        cpu_start = cpu_ns();
+                    }
+                    last = received_at;
+                    latency.record(received_at > sent_at ? received_at - sent_at : 0);
+                    ++received[publisher];
+                } else if (topic == kWarmup) {
+                    if (!warmed[publisher]) {
+                        warmed[publisher] = true;
+                        ++warmed_count;
+                    }
+                } else if (topic == kEnd) {
+                    if (!ended[publisher]) {
+                        ended[publisher] = true;
+                        ++ended_count;
+                    }
+                }
+            }
+        }
+        if (!reported_ready && warmed_count == publishers) {
+            write_line(result_fd, "ready");
+            reported_ready = true;
+        }
+    }
+    const uint64_t cpu = first == 0 ? 0 : cpu_ns() - cpu_start;
+
+    uint64_t total = 0;
+    for (uint64_t n : received) {
+        total += n;
+    }
+    const double window = last > first ? (last - first) / 1e9 : 0.0;
+    return {
+        {"role", "subscriber"},
+        {"id", id},
+        {"received", total},
+        {"received_per_publisher", received},
+        {"complete", ended_count == publishers},
+        {"first_ns", first},
+        {"last_ns", last},
+        {"receive_rate", window > 0 ? total / window : 0.0},
+        {"cpu_ns", cpu},
+        {"threads", thread_count()},
+        {"latency_us",
+         {
+             {"mean", latency.mean() / 1000.0},
+             {"p50", latency.percentile(50.0) / 1000.0},
+             {"p99", latency.percentile(99.0) / 1000.0},
+             {"p999", latency.percentile(99.9) / 1000.0},
+             {"max", latency.max() / 1000.0},
+         }},
+    };
+}
+
+struct Child {
+    pid_t pid;
+    int command_fd; // 父进程写，仅发布端
+    int result_fd;  // 父进程读
+};
+
+// fork 子进程运行 body，子进程的结果以一行 JSON 写回父进程
+template <typename Body>
+Child spawn(std::vector<int>& parent_fds, bool with_command, Body body) {
+    int result[2];
+    int command[2] = {-1, -1};
+    if (pipe(result) != 0 || (with_command && pipe(command) != 0)) {
+        throw std::runtime_error("pipe failed: " + std::string(std::strerror(errno)));
+    }
+    std::fflush(nullptr);
+    const pid_t pid = fork();
+    if (pid < 0) {
+        throw std::runtime_error("fork failed: " + std::string(std::strerror(errno)));
+    }
+    if (pid == 0) {
+        // 关闭继承的其他子进程的管道，否则父进程收不到 EOF
+        for (int fd : parent_fds) {
+            close(fd);
+        }
+        close(result[0]);
+        if (with_command) {
+            close(command[1]);
+        }
+        int status = 0;
+        nlohmann::json output;
+        try {
+            output = body(command[0], result[1]);
+        } catch (const std::exception& e) {
+            output = {{"error", e.what()}};
+            status = 1;
+        }
+        write_line(result[1], output.dump());
+        _exit(status);
+    }
+    close(result[1]);
+    parent_fds.push_back(result[0]);
+    if (with_command) {
+        close(command[0]);
+        parent_fds.push_back(command[1]);
+    }
+    return {pid, with_command ? command[1] : -1, result[0]};
+}
+
+nlohmann::json parse_result(const std::string& line) {
+    nlohmann::json result = nlohmann::json::parse(line, nullptr, false);
+    if (result.is_discarded()) {
+        return {{"error", "malformed result"}};
+    }
+    return result;
+}
+
+nlohmann::json run(const Config& config, const std::string& topology, int processes) {
+    static int run_id = 0;
+    const int run = ++run_id;
+    const int publishers = topology == "fanout" ? 1 : processes;
+    const int subscribers = topology == "fanin" ? 1 : processes;
+
+    std::vector<int> parent_fds;
+    std::vector<Child> pub_children;
+    std::vector<Child> sub_children;
+    for (int p = 0; p < publishers; ++p) {
+        pub_children.push_back(spawn(parent_fds, true, [&config, run, p](int command_fd, int) {
+            return publisher_main(config, run, p, command_fd);
+        }));
+    }
+    for (int s = 0; s < subscribers; ++s) {
+        sub_children.push_back(spawn(parent_fds, false, [&config, run, s, publishers](int, int result_fd) {
+            return subscriber_main(config, run, s, publishers, result_fd);
+        }));
+    }
+
+    std::string error;
+    std::string line;
+    for (const Child& child : sub_children) {
+        if (!read_line(child.result_fd, line, config.timeout_ms) || line != "ready") {
+            error = line.empty() ? "subscriber not ready" : line;
+            break;
+        }
+    }
+    for (const Child& child : pub_children) {
+        write_line(child.command_fd, error.empty() ? "g" : "q");
+    }
+
+    // 订阅端收齐结束标记后才输出结果，发送耗时按条数放宽等待时间
+    const uint64_t send_ms = config.rate != 0 ? config.messages * 1000 / config.rate : 0;
+    const int result_timeout = config.timeout_ms * 2 + static_cast<int>(std::min<uint64_t>(send_ms, 1u << 30));
+    nlohmann::json sub_results = nlohmann::json::array();
+    for (const Child& child : sub_children) {
+        sub_results.push_back(error.empty() && read_line(child.result_fd, line, result_timeout)
+                                  ? parse_result(line)
+                                  : nlohmann::json{{"error", "no result"}});
+    }
+    for (const Child& child : pub_children) {
+        write_line(child.command_fd, "q");
+    }
+    nlohmann::json pub_results = nlohmann::json::array();
+    for (const Child& child : pub_children) {
+        pub_results.push_back(read_line(child.result_fd, line, config.timeout_ms) ? parse_result(line)
+                                                                                  : nlohmann::json{{"error", "no result"}});
+    }
+
+    for (const Child& child : pub_children) {
+        kill(child.pid, SIGKILL); // 已退出的子进程不受影响 (尚未回收，pid 不会被复用)
+    }
+    for (const Child& child : sub_children) {
+        kill(child.pid, SIGKILL);
+    }
+    for (const Child& child : pub_children) {
+        waitpid(child.pid, nullptr, 0);
+    }
+    for (const Child& child : sub_children) {
+        waitpid(child.pid, nullptr, 0);
+    }
+    for (int fd : parent_fds) {
+        close(fd);
+    }
+
+    // 汇总
+    uint64_t sent = 0;
+    uint64_t received = 0;
+    uint64_t pub_cpu = 0;
+    uint64_t sub_cpu = 0;
+    uint64_t first = UINT64_MAX;
+    uint64_t last = 0;
+    double worst_p99 = 0;
+    double worst_max = 0;
+    std::vector<double> p50s;
+    for (const nlohmann::json& r : pub_results) {
+        if (r.contains("error")) {
+            error = "publisher: " + r["error"].get<std::string>();
+            continue;
+        }
+        sent += r["sent"].get<uint64_t>();
+        pub_cpu += r["cpu_ns"].get<uint64_t>();
+    }
+    for (const nlohmann::json& r : sub_results) {
+        if (r.contains("error")) {
+            error = "subscriber: " + r["error"].get<std::string>();
+            continue;
+        }
+        received += r["received"].get<uint64_t>();
+        sub_cpu += r["cpu_ns"].get<uint64_t>();
+        if (r["first_ns"].get<uint64_t>() != 0) {
+            first = std::min(first, r["first_ns"].get<uint64_t>());
+            last = std::max(last, r["last_ns"].get<uint64_t>());
+        }
+        const nlohmann::json& lat = r["latency_us"];
+        p50s.push_back(lat["p50"].get<double>());
+        worst_p99 = std::max(worst_p99, lat["p99"].get<double>());
+        worst_max = std::max(worst_max, lat["max"].get<double>());
+    }
+    std::sort(p50s.begin(), p50s.end());
+
+    const uint64_t expected = sent * static_cast<uint64_t>(subscribers);
+    const double window = last > first ? (last - first) / 1e9 : 0.0;
+    nlohmann::json result = {
+        {"topology", topology},
+        {"processes", processes},
+        {"publishers", publishers},
+        {"subscribers", subscribers},
+        {"message_size", config.size},
+        {"shared_context", config.shared_context},
+        {"aggregate",
+         {
+             {"sent", sent},
+             {"received", received},
+             {"loss_ratio", expected == 0 ? 0.0 : 1.0 - static_cast<double>(received) / expected},
+             {"throughput", window > 0 ? received / window : 0.0},
+             {"megabytes_per_sec", window > 0 ? received * config.size / window / 1e6 : 0.0},
+             {"publisher_cpu_ns_per_message", sent == 0 ? 0.0 : static_cast<double>(pub_cpu) / sent},
+             {"subscriber_cpu_ns_per_message", received == 0 ? 0.0 : static_cast<double>(sub_cpu) / received},
+             {"cpu_ns_per_delivered_message",
+              received == 0 ? 0.0 : static_cast<double>(pub_cpu + sub_cpu) / received},
+             {"median_p50_latency_us", p50s.empty() ? 0.0 : p50s[p50s.size() / 2]},
+             {"worst_p99_latency_us", worst_p99},
+             {"worst_max_latency_us", worst_max},
+         }},
+        {"publisher_results", pub_results},
+        {"subscriber_results", sub_results},
+    };
+    if (!error.empty()) {
+        result["error"] = error;
+    }
+    return result;
+}
+
+Config parse_args(int argc, char* argv[]) {
+    Config config;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            std::cout << "usage: zmq_simple_scale [--topology fanout|fanin|mesh|all] [--processes 8] [--size 256]\n"
+                         "                        [--messages 100000] [--rate 0] [--shared-context] [--json FILE|-]\n";
+            std::exit(0);
+        }
+        if (arg == "--shared-context") {
+            config.shared_context = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("missing value for " + arg);
+        }
+        const std::string value = argv[++i];
+        if (arg == "--topology") {
+            if (value == "fanout" || value == "fanin" || value == "mesh") {
+                config.topologies = {value};
+            } else if (value != "all") {
+                throw std::invalid_argument("unknown topology: " + value);
+            }
+        } else if (arg == "--processes") {
+            config.max_processes = std::max(1, std::stoi(value));
+        } else if (arg == "--size") {
+            config.size = std::max<size_t>(kStampSize, std::stoull(value));
+        } else if (arg == "--messages") {
+            config.messages = std::stoull(value);
+        } else if (arg == "--rate") {
+            config.rate = std::stoull(value);
+        } else if (arg == "--timeout") {
+            config.timeout_ms = std::max(100, std::stoi(value));
+        } else if (arg == "--json") {
+            config.json_path = value;
+        } else {
+            throw std::invalid_argument("unknown option: " + arg);
+        }
+    }
+    return config;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    try {
+        config = parse_args(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+
+    // IPC 端点所在目录
+    mkdir("/tmp/docker_share", 0777);
+
+    std::vector<int> counts;
+    for (int n = 1; n < config.max_processes; n *= 2) {
+        counts.push_back(n);
+    }
+    counts.push_back(config.max_processes);
+
+    // JSON 写到标准输出时表格改写到标准错误
+    std::ostream& table = config.json_path == "-" ? std::cerr : std::cout;
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-7s %5s %5s %12s %7s %10s %10s %9s %9s %8s\n", "topo", "pubs", "subs",
+                  "msg/s", "loss%", "pub ns/msg", "sub ns/msg", "p50(us)", "p99(us)", "threads");
+    table << line;
+
+    nlohmann::json results = nlohmann::json::array();
+    for (const std::string& topology : config.topologies) {
+        for (int processes : counts) {
+            nlohmann::json result;
+            try {
+                result = run(config, topology, processes);
+            } catch (const std::exception& e) {
+                std::cerr << topology << " processes=" << processes << ": " << e.what() << std::endl;
+                continue;
+            }
+            if (result.contains("error")) {
+                std::cerr << topology << " processes=" << processes << ": " << result["error"].get<std::string>()
+                          << std::endl;
+            }
+            // 订阅端的线程数随连接的发布端数增长 (每个 Context 一个 I/O 线程)
+            int threads = 0;
+            for (const nlohmann::json& r : result["subscriber_results"]) {
+                if (r.contains("threads")) {
+                    threads = std::max(threads, r["threads"].get<int>());
+                }
+            }
+            const nlohmann::json& agg = result["aggregate"];
+            std::snprintf(line, sizeof(line), "%-7s %5d %5d %12.0f %7.2f %10.0f %10.0f %9.1f %9.1f %8d\n",
+                          topology.c_str(), result["publishers"].get<int>(), result["subscribers"].get<int>(),
+                          agg["throughput"].get<double>(), agg["loss_ratio"].get<double>() * 100.0,
+                          agg["publisher_cpu_ns_per_message"].get<double>(),
+                          agg["subscriber_cpu_ns_per_message"].get<double>(),
+                          agg["median_p50_latency_us"].get<double>(), agg["worst_p99_latency_us"].get<double>(),
+                          threads);
+            table << line << std::flush;
+            results.push_back(std::move(result));
+        }
+    }
+
+    if (!config.json_path.empty()) {
+        const nlohmann::json doc = {
+            {"benchmark", "zmq_simple_scale"},
+            {"config",
+             {
+                 {"topologies", config.topologies},
+                 {"max_processes", config.max_processes},
+                 {"message_size", config.size},
+                 {"messages_per_publisher", config.messages},
+                 {"rate_per_publisher", config.rate},
+                 {"shared_context", config.shared_context},
+             }},
+            {"results", results},
+        };
+        if (config.json_path == "-") {
+            std::cout << doc.dump(2) << std::endl;
+        } else {
+            std::ofstream out(config.json_path);
+            out << doc.dump(2) << std::endl;
+            if (!out) {
+                std::cerr << "failed to write " << config.json_path << std::endl;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
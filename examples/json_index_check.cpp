@@ -0,0 +1,95 @@
+/*
+ * JSON 结构索引自检
+ *
+ * 用逐字节的参考实现对比 json_index 的标量、SSE4.2、AVX2 分类器 (跳过当前 CPU 不支持的实现)。
+ * 输入为随机拼接的括号、引号、反斜杠等字符，长度覆盖 64 字节块的边界。
+ *
+ * 用法: json_index_check [次数，默认 200000] [随机种子]
+ */
+
+#include "../src/json_index.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using zmq_simple::json_index::Isa;
+
+namespace {
+
+// 参考实现: 奇数个连续反斜杠之后的引号是转义的；字符串外的 { } [ ] : , 与未转义的引号为结构字符
+bool reference(const std::string& text, std::vector<uint32_t>& out) {
+    out.clear();
+    bool in_string = false;
+    size_t backslashes = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char c = text[i];
+        const bool escaped = backslashes % 2 == 1;
+        backslashes = c == '\\' ? backslashes + 1 : 0;
+        if (c == '"' && !escaped) {
+            in_string = !in_string;
+            out.push_back(static_cast<uint32_t>(i));
+        } else if (!in_string && (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',')) {
+            out.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return !in_string;
+}
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+    case Isa::Avx2: return "avx2";
+    case Isa::Sse42: return "sse4.2";
+    default: return "scalar";
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const long iterations = argc > 1 ? std::atol(argv[1]) : 200000;
+    std::mt19937 rng(argc > 2 ? static_cast<unsigned>(std::atol(argv[2])) : 1u);
+
+    // 只测试当前 CPU 支持的实现
+    std::vector<Isa> isas = {Isa::Scalar};
+    const Isa active = zmq_simple::json_index::active_isa();
+    if (active == Isa::Sse42 || active == Isa::Avx2) {
+        isas.push_back(Isa::Sse42);
+    }
+    if (active == Isa::Avx2) {
+        isas.push_back(Isa::Avx2);
+    }
+
+    // 结构字符与反斜杠占多数，容易构造出跨块的转义和字符串
+    const std::string alphabet = "{}[]:,\"\"\\\\\\ a1";
+    std::vector<uint32_t> expected;
+    std::vector<uint32_t> actual;
+    long failures = 0;
+    for (long n = 0; n < iterations; ++n) {
+        std::string text(rng() % 300, ' ');
+        for (char& c : text) {
+            c = alphabet[rng() % alphabet.size()];
+        }
+        const bool expected_ok = reference(text, expected);
+
+        for (Isa isa : isas) {
+            actual.assign(zmq_simple::json_index::capacity_for(text.size()), 0);
+            size_t count = 0;
+            const bool ok = zmq_simple::json_index::build(text.data(), text.size(), actual.data(), count, isa);
+            actual.resize(count);
+            if (ok != expected_ok || actual != expected) {
+                if (++failures <= 5) {
+                    std::cerr << isa_name(isa) << " mismatch on input: " << text << std::endl;
+                }
+            }
+        }
+    }
+
+    std::cout << "checked " << iterations << " inputs with";
+    for (Isa isa : isas) {
+        std::cout << " " << isa_name(isa);
+    }
+    std::cout << ": " << failures << " mismatches" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -1,4 +1,6 @@
 #include "../include/zmq_simple.hpp"
+#include "../include/zmq_simple_json.hpp"
+#include "../include/zmq_simple_template.hpp"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -22,41 +24,29 @@ int main()
 
     try
     {
-        zmq_simple::Publisher pub("A_publisher", zmq_simple::Transport::IPC);
-        zmq_simple::Subscriber sub_b("B_publisher", zmq_simple::Transport::IPC);
-        zmq_simple::Subscriber sub_c("C_publisher", zmq_simple::Transport::IPC);
+        zmq_simple::JsonPublisher pub("A_publisher", zmq_simple::Transport::IPC);
+        zmq_simple::JsonSubscriber sub_b("B_publisher", zmq_simple::Transport::IPC);
+        zmq_simple::JsonSubscriber sub_c("C_publisher", zmq_simple::Transport::IPC);
 
         sub_b.subscribe("");
         sub_c.subscribe("CA");
 
-        sub_b.start_loop([](const std::string &topic, const std::vector<uint8_t> &data)
-                         {
-            try {
-                json received = json::parse(data.begin(), data.end());
-                std::cout << "[B→A] " << received.dump() << std::endl;
-            } catch (const json::exception& e) {
-                std::cerr << "解析错误: " << e.what() << std::endl;
-            } });
+        sub_b.start_loop([](const std::string &topic, const json &received)
+                         { std::cout << "[B→A] " << received.dump() << std::endl; });
 
-        sub_c.start_loop([](const std::string &topic, const std::vector<uint8_t> &data)
-                         {
-            try {
-                json received = json::parse(data.begin(), data.end());
-                std::cout << "[C→A] " << received.dump() << std::endl;
-            } catch (const json::exception& e) {
-                std::cerr << "解析错误: " << e.what() << std::endl;
-            } });
+        sub_c.start_loop([](const std::string &topic, const json &received)
+                         { std::cout << "[C→A] " << received.dump() << std::endl; });
+
+        // 只有 count 每次变化，消息模板预先序列化，发布时只改写 count 槽位
+        zmq_simple::MessageTemplate message("{\"name\":\"A\",\"message\":\"A to ALL\",\"count\":${count:20}}");
+        const size_t count_slot = message.slot("count");
 
         int count = 0;
         while (running)
         {
-            json data = {
-                {"name", "A"},
-                {"message", "A to ALL"},
-                {"count", std::to_string(count)}};
-            std::string json_str = data.dump();
-            pub.publish("app_a_data", json_str);
-            std::cout << "[A Publish:] " << json_str << std::endl;
+            message.set(count_slot, count);
+            message.publish(pub.publisher(), "app_a_data");
+            std::cout << "[A Publish:] " << message.str() << std::endl;
             count++;
             std::this_thread::sleep_for(std::chrono::seconds(1));
         }
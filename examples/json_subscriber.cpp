@@ -1,4 +1,6 @@
 #include "../include/zmq_simple.hpp"
+#include "../include/zmq_simple_json.hpp"
+#include "../include/zmq_simple_template.hpp"
 #include <iostream>
 #include <string>
 #include <thread>
@@ -22,41 +24,29 @@ int main(int argc, char *argv[])
 
     try
     {
-        zmq_simple::Subscriber sub_a("A_publisher", zmq_simple::Transport::IPC);
-        zmq_simple::Subscriber sub_c("C_publisher", zmq_simple::Transport::IPC);
-        zmq_simple::Publisher pub("B_publisher", zmq_simple::Transport::IPC);
+        zmq_simple::JsonSubscriber sub_a("A_publisher", zmq_simple::Transport::IPC);
+        zmq_simple::JsonSubscriber sub_c("C_publisher", zmq_simple::Transport::IPC);
+        zmq_simple::JsonPublisher pub("B_publisher", zmq_simple::Transport::IPC);
 
         sub_a.subscribe("");
         sub_c.subscribe("CB");
 
-        sub_a.start_loop([&pub](const std::string &topic, const std::vector<uint8_t> &data)
-                         {
-            try {
-                json received = json::parse(data.begin(), data.end());
-                std::cout << "[A→B] " << received.dump() << std::endl;
-            } catch (const json::exception& e) {
-                std::cerr << "JSON 解析错误: " << e.what() << std::endl;
-            } });
+        sub_a.start_loop([&pub](const std::string &topic, const json &received)
+                         { std::cout << "[A→B] " << received.dump() << std::endl; });
 
-        sub_c.start_loop([&pub](const std::string &topic, const std::vector<uint8_t> &data)
-                         {
-            try {
-                json received = json::parse(data.begin(), data.end());
-                std::cout << "[C→B] " << received.dump() << std::endl;
-            } catch (const json::exception& e) {
-                std::cerr << "JSON 解析错误: " << e.what() << std::endl;
-            } });
+        sub_c.start_loop([&pub](const std::string &topic, const json &received)
+                         { std::cout << "[C→B] " << received.dump() << std::endl; });
+
+        // 只有 count 每次变化，消息模板预先序列化，发布时只改写 count 槽位
+        zmq_simple::MessageTemplate message("{\"name\":\"B\",\"message\":\"B to ALL\",\"count\":${count:20}}");
+        const size_t count_slot = message.slot("count");
 
         int count = 0;
         while (running)
         {
-            json response = {
-                {"name", "B"},
-                {"message", "B to ALL"},
-                {"count", std::to_string(count)}};
-            std::string json_str = response.dump();
-            pub.publish("app_b_data", json_str);
-            std::cout << "[B Publish:] " << json_str << std::endl;
+            message.set(count_slot, count);
+            message.publish(pub.publisher(), "app_b_data");
+            std::cout << "[B Publish:] " << message.str() << std::endl;
             count++;
             std::this_thread::sleep_for(std::chrono::seconds(2));
         }
@@ -0,0 +1,77 @@
+#include "../include/zmq_simple.hpp"
+#include "../include/zmq_simple_sax.hpp"
+#include <iostream>
+#include <string>
+#include <csignal>
+#include <atomic>
+
+// 配合 python/examples/json_publisher.py: 直接从消息字节解析到结构体，不构建 json DOM
+struct User
+{
+    int64_t id;
+    std::string name;
+    int age;
+    std::string email;
+    int64_t timestamp;
+    ZMQ_SIMPLE_DEFINE_SAX_INTRUSIVE(User, id, name, age, email, timestamp)
+};
+
+struct Sensor
+{
+    std::string sensor_id;
+    double temperature;
+    double humidity;
+    int64_t timestamp;
+    ZMQ_SIMPLE_DEFINE_SAX_INTRUSIVE(Sensor, sensor_id, temperature, humidity, timestamp)
+};
+
+std::atomic<bool> running(true);
+
+void signal_handler(int signal)
+{
+    running = false;
+}
+
+int main()
+{
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+
+    try
+    {
+        zmq_simple::Subscriber sub("test_json", zmq_simple::Transport::IPC);
+        sub.subscribe("user");
+        sub.subscribe("sensor");
+
+        // 结构体在循环外复用，字符串字段的容量也随之复用
+        User user = {};
+        Sensor sensor = {};
+        zmq_simple::Message message;
+
+        while (running)
+        {
+            if (!sub.receive(message, 1000))
+            {
+                continue;
+            }
+
+            if (message.topic() == "user" && zmq_simple::decode_sax(message, user))
+            {
+                std::cout << "[user] " << user.id << " " << user.name << " " << user.age << " " << user.email
+                          << std::endl;
+            }
+            else if (message.topic() == "sensor" && zmq_simple::decode_sax(message, sensor))
+            {
+                std::cout << "[sensor] " << sensor.sensor_id << " " << sensor.temperature << "°C "
+                          << sensor.humidity << "%" << std::endl;
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
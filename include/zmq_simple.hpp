@@ -1,6 +1,7 @@
 #ifndef ZMQ_SIMPLE_HPP
 #define ZMQ_SIMPLE_HPP
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
@@ -13,6 +14,129 @@ enum class Transport {
     INPROC 
 };
 
+// 负载内容类型，随 envelope 发送，便于 C++ 与 Python 端按类型解码
+enum class ContentType : uint8_t {
+    Raw = 0,      // 未标注，按应用约定解释
+    Json = 1,     // JSON 文本
+    Cbor = 2,
+    MsgPack = 3,
+    BJData = 4,
+    KeyDict = 5,  // 键字典编码: 键名按 Topic 学习为 schema，之后只发送值 (见 zmq_simple_json.hpp)
+    TimeSeries = 6, // 时间序列块 (见 zmq_simple_timeseries.hpp)
+    Columnar = 7,   // 列式微批块 (见 zmq_simple_columnar.hpp)
+    Flat = 8,       // 免解析的二进制布局 (见 zmq_simple_flat.hpp)
+    Array = 9,      // 多维数组，dtype 与形状在元数据中 (见 zmq_simple_array.hpp)
+};
+
+struct CompressionOptions {
+    size_t min_size = 1024;            // 无字典时，超过该长度才压缩
+    size_t dictionary_min_size = 64;   // 有字典时的压缩阈值，用于小消息
+    std::vector<uint8_t> dictionary;   // 可选，由 train_compression_dictionary 生成
+};
+
+struct StreamOptions {
+    size_t chunk_size = 256 * 1024;            // 发布端: 每块大小
+    uint32_t window = 16;                      // 订阅端: 允许未确认的块数
+    int credit_timeout_ms = 5000;              // 发布端: 订阅端无回应超过该时间则不再等待它
+    size_t max_stream_size = 1024 * 1024 * 1024; // 订阅端: 重组模式下单个流的最大长度
+};
+
+// 差分模式: 同一 Topic 的消息只发送相对上一版本的字节差分，适合变化很少的大状态文档
+struct DeltaOptions {
+    uint32_t keyframe_interval = 64; // 每 N 条消息发送一次完整版本
+    size_t min_size = 4096;          // 小于该长度的消息按原样发送
+};
+
+// 批量交付: 第一条消息到达后在 max_delay_ms 内继续接收，收满 max_batch 条或超时后一次回调
+struct BatchOptions {
+    size_t max_batch = 256;
+    int max_delay_ms = 5;
+};
+
+// 内存资源接口，分配/释放约定与 std::pmr::memory_resource 相同 (本库为 C++14，没有 <memory_resource>)。
+// 发布端的负载由 ZeroMQ 的 I/O 线程释放，实现须线程安全
+class MemoryResource {
+public:
+    virtual ~MemoryResource() = default;
+    virtual void* allocate(size_t size) = 0;           // 失败时抛出 std::bad_alloc
+    virtual void deallocate(void* p, size_t size) = 0;  // size 与 allocate 时相同
+};
+
+struct BufferPoolStats {
+    uint64_t allocations = 0;   // 总分配次数
+    uint64_t hits = 0;          // 由空闲块满足
+    uint64_t misses = 0;        // 按大小档位新分配
+    uint64_t oversize = 0;      // 超过最大档位，直接分配
+    size_t cached_bytes = 0;    // 池中空闲块的总大小
+    size_t in_use_bytes = 0;    // 已分配未释放的块的总大小 (按档位计)
+    size_t requested_bytes = 0; // 已分配未释放的请求长度之和
+
+    double hit_rate() const { return allocations == 0 ? 0.0 : static_cast<double>(hits) / allocations; }
+    // 内部碎片: 档位向上取整浪费的比例
+    double fragmentation() const {
+        return in_use_bytes == 0 ? 0.0 : 1.0 - static_cast<double>(requested_bytes) / in_use_bytes;
+    }
+};
+
+// 按 2 的幂分档 (64B ~ 4MB) 的缓冲池，每档独立加锁，释放的块留在池中复用
+class BufferPool : public MemoryResource {
+public:
+    explicit BufferPool(size_t max_cached_bytes = 64 * 1024 * 1024);
+    ~BufferPool() override;
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    void* allocate(size_t size) override;
+    void deallocate(void* p, size_t size) override;
+
+    BufferPoolStats stats() const;
+    // 释放所有空闲块
+    void trim();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl_;
+};
+
+// 从样本消息中训练压缩字典，发布端与订阅端需使用同一份字典
+std::vector<uint8_t> train_compression_dictionary(const std::vector<std::string>& samples,
+                                                  size_t capacity = 16 * 1024);
+
+// 接收到的消息。负载直接引用底层内存(ZeroMQ 消息、memfd 映射或解码缓冲区)，不做复制，
+// 复制 Message 只增加引用计数
+class Message {
+public:
+    Message() : data_(nullptr), size_(0), content_type_(ContentType::Raw) {}
+    Message(std::string topic, const uint8_t* data, size_t size, std::shared_ptr<void> holder,
+            ContentType content_type = ContentType::Raw)
+        : topic_(std::move(topic)), data_(data), size_(size), content_type_(content_type),
+          holder_(std::move(holder)) {}
+
+    const std::string& topic() const { return topic_; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    ContentType content_type() const { return content_type_; }
+
+    // 发布端随 envelope 附带的元数据 (如数组的 dtype 与形状)，没有时为空
+    const std::string& metadata() const {
+        static const std::string empty;
+        return metadata_ ? *metadata_ : empty;
+    }
+    void set_metadata(std::string metadata) {
+        metadata_ = std::make_shared<const std::string>(std::move(metadata));
+    }
+
+private:
+    std::string topic_;
+    const uint8_t* data_;
+    size_t size_;
+    ContentType content_type_;
+    std::shared_ptr<void> holder_;
+    std::shared_ptr<const std::string> metadata_;
+};
+
 class Context {
 public:
     Context();
@@ -29,6 +153,25 @@ private:
 
 class Publisher {
 public:
+    // 流式发布: 数据按块发送，受订阅端信用控制，内存占用与总长度无关
+    // Stream 不能比创建它的 Publisher 存活更久
+    class Stream {
+    public:
+        Stream(Stream&& other) noexcept;
+        Stream& operator=(Stream&& other) noexcept;
+        ~Stream();
+
+        bool write(const void* data, size_t size);
+        bool write(const std::string& data);
+        bool close();
+
+    private:
+        friend class Publisher;
+        class Impl;
+        explicit Stream(std::unique_ptr<Impl> impl);
+        std::unique_ptr<Impl> pimpl_;
+    };
+
     Publisher(const std::string& endpoint, Transport transport = Transport::IPC);
     Publisher(const std::string& endpoint, Transport transport, Context& shared_context);
 
@@ -39,6 +182,32 @@ public:
 
     bool publish(const std::string& topic, const std::string& data);
     bool publish(const std::string& topic, const void* data, size_t size);
+    bool publish(const std::string& topic, const void* data, size_t size, ContentType content_type);
+    // 零拷贝发布: ZeroMQ 直接引用 data，发送完成后释放 holder (可能在 ZeroMQ 的 I/O 线程中)，
+    // 此前调用方不得修改 data。小负载以及需要压缩、差分或 memfd 处理的负载仍然复制。
+    // metadata 随 envelope 发送，订阅端由 Message::metadata 取得；带元数据的消息不做差分
+    bool publish_shared(const std::string& topic, const void* data, size_t size, std::shared_ptr<void> holder,
+                        ContentType content_type = ContentType::Raw, const std::string& metadata = std::string());
+
+    void set_compression(const CompressionOptions& options);
+    void disable_compression();
+
+    void enable_streaming(const StreamOptions& options = StreamOptions());
+    Stream open_stream(const std::string& topic);
+
+    // 超过阈值的负载写入 sealed memfd，描述符经旁路 Unix 套接字传递 (仅 Linux + IPC)。
+    // 没有订阅端开启 Subscriber::enable_memfd 时仍按普通消息发送；只要有一个开启，
+    // 其余订阅端 (包括 Python 端) 都收不到这些消息，因此所有订阅端须同时开启
+    void enable_memfd(size_t threshold = 1024 * 1024);
+
+    // 不小于 min_size 的负载从 resource 分配后交给 ZeroMQ，发送完成后经 zmq_msg_init_data 的
+    // 释放回调归还，不再由 libzmq 按消息 malloc。传入 nullptr 恢复默认行为。
+    // 未发出的消息各自持有 resource 的引用，之后更换 resource 或 Publisher 析构都不影响归还
+    void set_memory_resource(std::shared_ptr<MemoryResource> resource, size_t min_size = 1024);
+
+    // 开启差分模式，订阅端据此透明地还原完整消息。除定期的完整版本外，
+    // 订阅端加入或发现版本缺失时经控制通道请求完整版本
+    void enable_delta(const DeltaOptions& options = DeltaOptions());
    
 private:
     class Impl;
@@ -48,6 +217,11 @@ private:
 class Subscriber {
 public:
     using MessageCallback = std::function<void(const std::string& topic, const std::vector<uint8_t>& data)>;
+    using MessageViewCallback = std::function<void(const Message& message)>;
+    using ChunkCallback = std::function<void(const std::string& topic, uint64_t stream_id,
+                                             const uint8_t* data, size_t size, bool last)>;
+    // batch 在回调返回后清空复用，需要保留的消息在回调中复制 (Message 复制只增加引用计数)
+    using BatchCallback = std::function<void(std::vector<Message>& batch)>;
 
     Subscriber(const std::string& endpoint, Transport transport = Transport::IPC); 
     Subscriber(const std::string& endpoint, Transport transport, Context& shared_context);
@@ -60,11 +234,74 @@ public:
     bool subscribe(const std::string& topic = "");  
     bool unsubscribe(const std::string& topic);
 
+    // 解压带字典的消息时使用，须与发布端字典一致
+    void set_compression_dictionary(const std::vector<uint8_t>& dictionary);
+
+    // 接收流式消息，默认重组为完整消息后由 receive/start_loop 交付
+    // 设置块回调后每块直接回调，不再重组；须在 start_loop 之前调用
+    void enable_streaming(const StreamOptions& options = StreamOptions());
+    void set_chunk_callback(ChunkCallback callback);
+
+    // 接收 memfd 负载，Message 直接引用只读映射 (仅 Linux + IPC)
+    void enable_memfd();
+    // 因未开启 enable_memfd 或等不到描述符而丢弃的 memfd 消息数
+    uint64_t memfd_dropped() const;
+
+    // 解压等需要新缓冲区的消息从 resource 分配，Message 释放时归还
+    void set_memory_resource(std::shared_ptr<MemoryResource> resource);
+
+    // 差分消息总是透明还原；开启后订阅时和发现版本缺失时立即向发布端请求完整版本，
+    // 否则要等到下一个定期的完整版本
+    void enable_delta();
+
+    // 内容过滤: 在解析和回调之前直接对负载求值，多个条件同时满足才交付
+    // 例如 "/temperature > 30"、"/sensor_id == \"temp_sensor_01\""；表达式无效返回 false
+    // 支持 JSON 文本 (Raw/Json)、CBOR 与 MessagePack。其他编码 (BJData、KeyDict 等) 无法求值，
+    // 设置了条件时这些消息不会交付
+    // 须在 start_loop 之前调用
+    bool add_filter(const std::string& expression);
+    void clear_filters();
+
     bool receive(std::string& topic, std::vector<uint8_t>& data, int timeout_ms = -1);
+    bool receive(Message& message, int timeout_ms = -1);
+
+    // 接入外部事件循环 (epoll、asyncio): fd() 为 socket 的 ZMQ_FD，边沿触发，只表示状态可能变化。
+    // 可读通知后须反复 receive(message, 0)，直到 readable() 返回 false 再等待下一次通知
+    int fd() const;
+    bool readable() const;
     
     bool start_loop(MessageCallback callback);
+    // 回调直接拿到 Message (含 content type)，不复制负载
+    bool start_message_loop(MessageViewCallback callback);
+    // 按批回调，适合每次回调有固定开销的场景 (如 Python 绑定中获取 GIL)
+    bool start_batch_loop(BatchCallback callback, const BatchOptions& options = BatchOptions());
     void stop_loop();
 
+private:
+    friend class Poller;
+    class Impl;
+    std::unique_ptr<Impl> pimpl_;
+};
+
+// 在一个线程中同时等待多个 Subscriber (zmq_poll)，可读后由调用方 receive(message, 0) 取出。
+// Subscriber 须比 Poller 存活更久；加入 Poller 的 Subscriber 只在等待它的线程中接收，不再 start_loop
+class Poller {
+public:
+    Poller();
+    ~Poller();
+
+    Poller(const Poller&) = delete;
+    Poller& operator=(const Poller&) = delete;
+
+    // 返回序号，重复加入返回原序号；remove 之后的序号前移
+    size_t add(Subscriber& subscriber);
+    bool remove(Subscriber& subscriber);
+
+    // 等待至少一个 Subscriber 可读，ready 为可读的序号；超时返回 false
+    bool wait(std::vector<size_t>& ready, int timeout_ms = -1);
+    Subscriber& at(size_t index) const;
+    size_t size() const;
+
 private:
     class Impl;
     std::unique_ptr<Impl> pimpl_;
@@ -0,0 +1,191 @@
+#ifndef ZMQ_SIMPLE_ARRAY_HPP
+#define ZMQ_SIMPLE_ARRAY_HPP
+
+#include "zmq_simple.hpp"
+#include <cstring>
+#include <type_traits>
+
+namespace zmq_simple {
+
+// 多维数组通道 (ContentType::Array): 负载为数组数据本身，dtype、形状与步长放在消息元数据中，
+// 发布端零拷贝 (publish_shared)，订阅端直接在消息内存上构造数组视图。与 Python 的
+// Publisher.publish_array / Subscriber.receive_array (numpy) 互通:
+//   ArrayInfo info = ArrayInfo::contiguous<float>({480, 640});
+//   publish_array(pub, "frame", info, pixels.data(), pixels.size() * sizeof(float), holder);
+//
+//   ArrayInfo info;
+//   if (decode_array(message, info) && info.is<float>()) { const float* p = info.data<float>(message); ... }
+namespace array {
+
+const uint8_t kMagic = 0x4E; // 'N'
+const uint8_t kVersion = 1;
+const size_t kMaxDims = 64;
+
+#pragma pack(push, 1)
+struct Header {
+    uint8_t magic;
+    uint8_t version;
+    char byte_order;   // '<' 小端、'>' 大端、'|' 与字节序无关
+    char kind;         // numpy dtype.kind: 'b' 'i' 'u' 'f' 'c'
+    uint32_t itemsize;
+    uint8_t ndim;
+    uint8_t reserved[7];
+    // 后接 int64 shape[ndim]、int64 strides[ndim] (字节)
+};
+#pragma pack(pop)
+
+} // namespace array
+
+struct ArrayInfo {
+    char byte_order = '|';
+    char kind = 'u';
+    size_t itemsize = 1;
+    std::vector<int64_t> shape;
+    std::vector<int64_t> strides;
+
+    // numpy 的 dtype.str，例如 "<f8"
+    std::string typestr() const { return std::string(1, byte_order) + kind + std::to_string(itemsize); }
+
+    size_t count() const {
+        size_t n = 1;
+        for (int64_t d : shape) {
+            n *= static_cast<size_t>(d);
+        }
+        return n;
+    }
+
+    template <typename T>
+    bool is() const {
+        return itemsize == sizeof(T) && kind == kind_of<T>() && (itemsize == 1 || byte_order == native_order());
+    }
+
+    // 调用方先用 is<T>() 检查类型；负载地址不满足 T 的对齐时返回 nullptr
+    template <typename T>
+    const T* data(const Message& message) const {
+        return reinterpret_cast<uintptr_t>(message.data()) % alignof(T) == 0
+                   ? reinterpret_cast<const T*>(message.data())
+                   : nullptr;
+    }
+
+    // 按行优先 (C order) 连续存放的数组
+    template <typename T>
+    static ArrayInfo contiguous(const std::vector<int64_t>& shape) {
+        ArrayInfo info;
+        info.byte_order = sizeof(T) == 1 ? '|' : native_order();
+        info.kind = kind_of<T>();
+        info.itemsize = sizeof(T);
+        info.shape = shape;
+        info.strides.assign(shape.size(), 0);
+        int64_t stride = static_cast<int64_t>(sizeof(T));
+        for (size_t i = shape.size(); i-- > 0;) {
+            info.strides[i] = stride;
+            stride *= shape[i];
+        }
+        return info;
+    }
+
+    template <typename T>
+    static char kind_of() {
+        static_assert(std::is_arithmetic<T>::value, "array elements must be arithmetic");
+        return std::is_same<T, bool>::value ? 'b'
+               : std::is_floating_point<T>::value ? 'f'
+               : std::is_signed<T>::value ? 'i'
+                                          : 'u';
+    }
+
+    static char native_order() {
+        const uint16_t probe = 1;
+        uint8_t first = 0;
+        std::memcpy(&first, &probe, 1);
+        return first == 1 ? '<' : '>';
+    }
+};
+
+inline std::string encode_array_metadata(const ArrayInfo& info) {
+    array::Header header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = array::kMagic;
+    header.version = array::kVersion;
+    header.byte_order = info.byte_order;
+    header.kind = info.kind;
+    header.itemsize = static_cast<uint32_t>(info.itemsize);
+    header.ndim = static_cast<uint8_t>(info.shape.size());
+
+    std::string out(sizeof(header) + info.shape.size() * 2 * sizeof(int64_t), '\0');
+    std::memcpy(&out[0], &header, sizeof(header));
+    if (!info.shape.empty()) {
+        std::memcpy(&out[sizeof(header)], info.shape.data(), info.shape.size() * sizeof(int64_t));
+        std::memcpy(&out[sizeof(header) + info.shape.size() * sizeof(int64_t)], info.strides.data(),
+                    info.strides.size() * sizeof(int64_t));
+    }
+    return out;
+}
+
+// 解析元数据并检查所有元素都落在 size 字节的负载内 (步长须非负)
+inline bool decode_array_metadata(const std::string& metadata, size_t size, ArrayInfo& info) {
+    array::Header header;
+    if (metadata.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, metadata.data(), sizeof(header));
+    if (header.magic != array::kMagic || header.version != array::kVersion || header.ndim > array::kMaxDims ||
+        header.itemsize == 0 || metadata.size() != sizeof(header) + header.ndim * 2 * sizeof(int64_t) ||
+        std::strchr("biufc", header.kind) == nullptr || header.kind == '\0' ||
+        std::strchr("<>|", header.byte_order) == nullptr || header.byte_order == '\0') {
+        return false;
+    }
+
+    info.byte_order = header.byte_order;
+    info.kind = header.kind;
+    info.itemsize = header.itemsize;
+    info.shape.resize(header.ndim);
+    info.strides.resize(header.ndim);
+    if (header.ndim != 0) {
+        std::memcpy(info.shape.data(), metadata.data() + sizeof(header), header.ndim * sizeof(int64_t));
+        std::memcpy(info.strides.data(), metadata.data() + sizeof(header) + header.ndim * sizeof(int64_t),
+                    header.ndim * sizeof(int64_t));
+    }
+
+    // 最后一个元素的偏移 + itemsize 不超过负载长度；空数组不访问内存
+    for (size_t i = 0; i < header.ndim; ++i) {
+        if (info.shape[i] < 0 || info.strides[i] < 0) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < header.ndim; ++i) {
+        if (info.shape[i] == 0) {
+            return true;
+        }
+    }
+    uint64_t extent = 0;
+    for (size_t i = 0; i < header.ndim; ++i) {
+        const uint64_t span = static_cast<uint64_t>(info.shape[i] - 1);
+        const uint64_t stride = static_cast<uint64_t>(info.strides[i]);
+        if (stride != 0 && span > (UINT64_MAX - extent) / stride) {
+            return false;
+        }
+        extent += span * stride;
+    }
+    return extent <= size && header.itemsize <= size - extent;
+}
+
+inline bool decode_array(const Message& message, ArrayInfo& info) {
+    return message.content_type() == ContentType::Array &&
+           decode_array_metadata(message.metadata(), message.size(), info);
+}
+
+// holder 持有 data 直到发送完成；为空时先复制 (小数组或调用方不便保持数据不变时)
+inline bool publish_array(Publisher& publisher, const std::string& topic, const ArrayInfo& info, const void* data,
+                          size_t size, std::shared_ptr<void> holder = nullptr) {
+    const std::string metadata = encode_array_metadata(info);
+    if (!holder) {
+        auto copy = std::make_shared<std::vector<uint8_t>>(static_cast<const uint8_t*>(data),
+                                                          static_cast<const uint8_t*>(data) + size);
+        return publisher.publish_shared(topic, copy->data(), copy->size(), copy, ContentType::Array, metadata);
+    }
+    return publisher.publish_shared(topic, data, size, std::move(holder), ContentType::Array, metadata);
+}
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_ARRAY_HPP
@@ -0,0 +1,148 @@
+#ifndef ZMQ_SIMPLE_COLUMNAR_HPP
+#define ZMQ_SIMPLE_COLUMNAR_HPP
+
+#include "zmq_simple.hpp"
+#include <chrono>
+#include <cstring>
+
+namespace zmq_simple {
+
+// 列式微批通道 (ContentType::Columnar): 发布端逐行写入，攒够 N 行或超过时间窗口后
+// 转置为按列存储的块作为一条消息发送。块内每列起始位置按 64 字节对齐，可选按列 LZ4 压缩。
+// 订阅端 ColumnarBlock 直接引用消息中的列数据 (未压缩时不复制)，便于向量化聚合:
+//   ColumnarPublisher batch(pub, "trades", {{"price", ColumnType::Float64}, {"qty", ColumnType::Int64}});
+//   batch.begin_row(); batch.set(0, 101.5); batch.set(1, int64_t(300)); batch.end_row();
+//
+//   ColumnarBlock block;
+//   if (block.parse(message)) { auto price = block.float64s(block.find("price")); ... }
+enum class ColumnType : uint8_t {
+    Int64 = 1,
+    Float64 = 2,
+    Bool = 3,   // 每行 1 字节，0 或 1
+    String = 4, // rows + 1 个 uint32 偏移，后接字符数据
+};
+
+struct ColumnSpec {
+    std::string name;
+    ColumnType type;
+};
+
+struct ColumnarOptions {
+    size_t max_rows = 4096;     // 攒够该行数时发送
+    int max_delay_ms = 100;     // 第一行写入超过该时间时发送 (在 end_row 时检查)
+    bool compress = false;      // 按列 LZ4 压缩，只保留有收益的列
+};
+
+// 连续内存的只读视图
+template <typename T>
+class ColumnSpan {
+public:
+    ColumnSpan() : data_(nullptr), size_(0) {}
+    ColumnSpan(const T* data, size_t size) : data_(data), size_(size) {}
+
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+private:
+    const T* data_;
+    size_t size_;
+};
+
+class ColumnarPublisher {
+public:
+    ColumnarPublisher(Publisher& publisher, const std::string& topic, const std::vector<ColumnSpec>& columns,
+                      const ColumnarOptions& options = ColumnarOptions());
+    ~ColumnarPublisher();
+
+    ColumnarPublisher(const ColumnarPublisher&) = delete;
+    ColumnarPublisher& operator=(const ColumnarPublisher&) = delete;
+
+    // 列序号，不存在时抛出 std::runtime_error
+    size_t column(const std::string& name) const;
+
+    // 开始新的一行，未设置的列为 0 / false / 空字符串
+    void begin_row();
+    // 设置当前行的值。Float64 列也接受整数；类型不符或尚未 begin_row 时返回 false
+    bool set(size_t column, int64_t value);
+    bool set(size_t column, int value) { return set(column, static_cast<int64_t>(value)); }
+    bool set(size_t column, double value);
+    bool set(size_t column, bool value);
+    bool set(size_t column, const std::string& value);
+    bool set(size_t column, const char* value, size_t size);
+    // 字符串字面量否则会隐式转换为 bool
+    bool set(size_t column, const char* value) { return set(column, value, std::strlen(value)); }
+    // 结束当前行，达到发送条件时在此发送，返回发送结果
+    bool end_row();
+
+    // 发送已缓冲的行，没有行时不发送
+    bool flush();
+    size_t rows() const { return rows_; }
+
+private:
+    struct Column {
+        ColumnSpec spec;
+        std::vector<uint8_t> data;      // 定长列的值
+        std::vector<uint32_t> offsets;  // 字符串列
+        std::string chars;
+    };
+
+    Publisher& publisher_;
+    std::string topic_;
+    ColumnarOptions options_;
+    std::vector<Column> columns_;
+    size_t rows_;
+    bool in_row_;
+    std::chrono::steady_clock::time_point first_row_;
+    std::vector<uint8_t> buffer_;
+    std::vector<uint8_t> scratch_;
+};
+
+// 解析后的列式块。未压缩的列直接引用消息内存；压缩的列，或地址不满足自然对齐的列，
+// 解码到块自己的缓冲区 (重复 parse 时复用)
+class ColumnarBlock {
+public:
+    struct StringRef {
+        const char* data;
+        size_t size;
+    };
+
+    static const size_t kNoColumn = static_cast<size_t>(-1);
+
+    // 持有 message 的引用，视图在下一次 parse 之前有效
+    bool parse(const Message& message);
+    // 不持有数据，调用方保证数据在使用期间有效
+    bool parse(const uint8_t* data, size_t size);
+
+    size_t rows() const { return rows_; }
+    size_t columns() const { return columns_.size(); }
+    const std::string& name(size_t column) const { return columns_[column].name; }
+    ColumnType type(size_t column) const { return columns_[column].type; }
+    size_t find(const std::string& name) const;
+
+    // 类型不符时返回空视图
+    ColumnSpan<int64_t> int64s(size_t column) const;
+    ColumnSpan<double> float64s(size_t column) const;
+    ColumnSpan<uint8_t> bools(size_t column) const;
+    StringRef string(size_t column, size_t row) const;
+
+private:
+    struct Column {
+        std::string name;
+        ColumnType type;
+        const uint8_t* data;
+        size_t size;
+    };
+
+    Message message_;
+    size_t rows_ = 0;
+    std::vector<Column> columns_;
+    std::vector<std::vector<uint64_t>> owned_; // 以 uint64_t 分配保证 8 字节对齐
+};
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_COLUMNAR_HPP
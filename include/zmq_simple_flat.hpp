@@ -0,0 +1,247 @@
+#ifndef ZMQ_SIMPLE_FLAT_HPP
+#define ZMQ_SIMPLE_FLAT_HPP
+
+#include "zmq_simple.hpp"
+#include "zmq_simple_columnar.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace zmq_simple {
+
+// 免解析的二进制布局 (ContentType::Flat): 消息布局即结构体的内存布局，读取字段就是一次内存访问。
+//   struct SensorReading {
+//       ZMQ_SIMPLE_FLAT_TYPE(0x53454E31)
+//       int64_t timestamp;
+//       double temperature;
+//       flat::String sensor_id;     // 变长字段: 消息尾部的偏移与长度
+//       flat::Vector<float> samples;
+//   };
+//   FlatBuilder<SensorReading> builder;
+//   builder.root().timestamp = ts;
+//   builder.set_string(&SensorReading::sensor_id, "temp_sensor_01");
+//   builder.publish(pub, "sensor");
+//
+//   FlatView<SensorReading> view;
+//   if (view.reset(message)) { double t = view->temperature; auto id = view.string(view->sensor_id); }
+//
+// 布局: [FlatHeader 16 字节][根结构体][变长数据，每段 8 字节对齐]，偏移均相对负载起始。
+// 版本演进只能在结构体末尾追加字段: 旧读端忽略多出的部分，新读端读旧消息时缺少的字段为 0
+namespace flat {
+
+const uint8_t kMagic = 0x46; // 'F'
+const uint8_t kVersion = 1;
+const size_t kAlignment = 8;
+
+#pragma pack(push, 1)
+struct Header {
+    uint8_t magic;
+    uint8_t version;
+    uint16_t reserved;
+    uint32_t type_id;   // 区分不同的结构体
+    uint32_t root_size; // 写端的 sizeof(根结构体)
+    uint32_t reserved2;
+};
+#pragma pack(pop)
+
+struct String {
+    uint32_t offset;
+    uint32_t size;
+};
+
+template <typename E>
+struct Vector {
+    uint32_t offset;
+    uint32_t size; // 元素个数
+};
+
+template <typename T>
+struct Check {
+    static_assert(std::is_trivially_copyable<T>::value && std::is_standard_layout<T>::value,
+                  "flat root must be a trivially copyable standard-layout struct");
+    static_assert(alignof(T) <= kAlignment, "flat root alignment must not exceed 8");
+    static const uint32_t type_id = T::zmq_simple_flat_type_id;
+};
+
+} // namespace flat
+
+// 在根结构体内声明类型 ID，读端据此拒绝其他类型的消息
+#define ZMQ_SIMPLE_FLAT_TYPE(id) static const uint32_t zmq_simple_flat_type_id = (id);
+
+// 直接在负载缓冲区中构建消息，发布后可 reset 复用
+template <typename T>
+class FlatBuilder {
+public:
+    FlatBuilder() { reset(); }
+
+    // 清空为全 0 的根结构体，保留缓冲区容量
+    void reset() {
+        buffer_.assign(kRootOffset + sizeof(T), 0);
+        flat::Header header;
+        std::memset(&header, 0, sizeof(header));
+        header.magic = flat::kMagic;
+        header.version = flat::kVersion;
+        header.type_id = flat::Check<T>::type_id;
+        header.root_size = static_cast<uint32_t>(sizeof(T));
+        std::memcpy(buffer_.data(), &header, sizeof(header));
+        align();
+    }
+
+    // 根结构体直接位于缓冲区中。写入变长数据会使之前取得的引用失效
+    T& root() { return *reinterpret_cast<T*>(buffer_.data() + kRootOffset); }
+
+    // 写入变长数据并设置根结构体中的字段
+    void set_string(flat::String T::*field, const char* data, size_t size) {
+        const flat::String ref = add_string(data, size);
+        root().*field = ref;
+    }
+
+    void set_string(flat::String T::*field, const std::string& value) { set_string(field, value.data(), value.size()); }
+
+    template <typename E>
+    void set_vector(flat::Vector<E> T::*field, const E* data, size_t count) {
+        const flat::Vector<E> ref = add_vector(data, count);
+        root().*field = ref;
+    }
+
+    template <typename E>
+    void set_vector(flat::Vector<E> T::*field, const std::vector<E>& values) { set_vector(field, values.data(), values.size()); }
+
+    // 只写入变长数据，返回的句柄由调用方赋给字段 (须先取得句柄再调用 root()，
+    // 不能写成 root().x = add_string(...)，C++14 中两侧的求值顺序不确定)
+    flat::String add_string(const char* data, size_t size) {
+        flat::String ref = {append(data, size), static_cast<uint32_t>(size)};
+        return ref;
+    }
+
+    flat::String add_string(const std::string& value) { return add_string(value.data(), value.size()); }
+
+    template <typename E>
+    flat::Vector<E> add_vector(const E* data, size_t count) {
+        static_assert(std::is_trivially_copyable<E>::value && alignof(E) <= flat::kAlignment,
+                      "flat vector elements must be trivially copyable with alignment <= 8");
+        flat::Vector<E> ref = {append(data, count * sizeof(E)), static_cast<uint32_t>(count)};
+        return ref;
+    }
+
+    template <typename E>
+    flat::Vector<E> add_vector(const std::vector<E>& values) { return add_vector(values.data(), values.size()); }
+
+    const uint8_t* data() const { return buffer_.data(); }
+    size_t size() const { return buffer_.size(); }
+
+    bool publish(Publisher& publisher, const std::string& topic) const {
+        return publisher.publish(topic, buffer_.data(), buffer_.size(), ContentType::Flat);
+    }
+
+private:
+    static const size_t kRootOffset = sizeof(flat::Header);
+
+    uint32_t append(const void* data, size_t size) {
+        const size_t offset = buffer_.size();
+        if (offset + size > UINT32_MAX) {
+            throw std::length_error("flat message exceeds 4GB");
+        }
+        buffer_.resize(offset + size);
+        if (size != 0) {
+            std::memcpy(buffer_.data() + offset, data, size);
+        }
+        align();
+        return static_cast<uint32_t>(offset);
+    }
+
+    void align() {
+        buffer_.resize((buffer_.size() + flat::kAlignment - 1) / flat::kAlignment * flat::kAlignment, 0);
+    }
+
+    std::vector<uint8_t> buffer_;
+};
+
+// 负载上的只读视图。负载地址 8 字节对齐且写端结构体不小于读端时不复制，
+// 否则复制到视图自己的缓冲区 (ZeroMQ 的大消息通常满足对齐)
+template <typename T>
+class FlatView {
+public:
+    FlatView() : data_(nullptr), size_(0), root_(nullptr) {}
+
+    // 持有 message 的引用，视图在下一次 reset 之前有效
+    bool reset(const Message& message) {
+        if (message.content_type() != ContentType::Flat || !reset(message.data(), message.size())) {
+            message_ = Message();
+            return false;
+        }
+        message_ = message;
+        return true;
+    }
+
+    // 不持有数据，调用方保证数据在使用期间有效
+    bool reset(const uint8_t* data, size_t size) {
+        message_ = Message();
+        data_ = nullptr;
+        size_ = 0;
+        root_ = nullptr;
+
+        flat::Header header;
+        if (size < sizeof(header)) {
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (header.magic != flat::kMagic || header.version != flat::kVersion ||
+            header.type_id != flat::Check<T>::type_id || header.root_size > size - sizeof(header)) {
+            return false;
+        }
+
+        if (reinterpret_cast<uintptr_t>(data) % flat::kAlignment != 0) {
+            owned_.resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+            std::memcpy(owned_.data(), data, size);
+            data = reinterpret_cast<const uint8_t*>(owned_.data());
+        }
+        if (header.root_size >= sizeof(T)) {
+            root_ = reinterpret_cast<const T*>(data + sizeof(header));
+        } else {
+            // 旧版本写端: 末尾缺少的字段为 0
+            std::memset(&fallback_, 0, sizeof(fallback_));
+            std::memcpy(&fallback_, data + sizeof(header), header.root_size);
+            root_ = &fallback_;
+        }
+        data_ = data;
+        size_ = size;
+        return true;
+    }
+
+    bool valid() const { return root_ != nullptr; }
+    const T& operator*() const { return *root_; }
+    const T* operator->() const { return root_; }
+
+    // 变长字段只做边界检查，越界时返回空视图
+    ColumnSpan<char> string(const flat::String& ref) const {
+        if (!in_bounds(ref.offset, ref.size)) {
+            return ColumnSpan<char>();
+        }
+        return ColumnSpan<char>(reinterpret_cast<const char*>(data_ + ref.offset), ref.size);
+    }
+
+    template <typename E>
+    ColumnSpan<E> vector(const flat::Vector<E>& ref) const {
+        if (ref.offset % alignof(E) != 0 || !in_bounds(ref.offset, static_cast<uint64_t>(ref.size) * sizeof(E))) {
+            return ColumnSpan<E>();
+        }
+        return ColumnSpan<E>(reinterpret_cast<const E*>(data_ + ref.offset), ref.size);
+    }
+
+private:
+    bool in_bounds(uint64_t offset, uint64_t size) const {
+        return data_ != nullptr && offset <= size_ && size <= size_ - offset;
+    }
+
+    Message message_;
+    const uint8_t* data_;
+    size_t size_;
+    const T* root_;
+    T fallback_;
+    std::vector<uint64_t> owned_;
+};
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_FLAT_HPP
@@ -0,0 +1,756 @@
+#ifndef ZMQ_SIMPLE_JSON_HPP
+#define ZMQ_SIMPLE_JSON_HPP
+
+#include "zmq_simple.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <random>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+namespace zmq_simple {
+
+// JSON 编解码层: 同一份文档可以按 Topic 选择文本或二进制编码 (CBOR/MsgPack/BJData)，
+// content type 随 envelope 发送，接收端据此选择解码方式
+
+// nlohmann 的文本序列化器只接受 char 输出，这里直接追加到 uint8_t 缓冲区，不经过临时 std::string
+class JsonTextOutput : public nlohmann::detail::output_adapter_protocol<char> {
+public:
+    explicit JsonTextOutput(std::vector<uint8_t>& out) : out_(out) {}
+
+    void write_character(char c) override { out_.push_back(static_cast<uint8_t>(c)); }
+    void write_characters(const char* s, std::size_t length) override { out_.insert(out_.end(), s, s + length); }
+
+private:
+    std::vector<uint8_t>& out_;
+};
+
+// 与 doc.dump() 输出相同，追加到 buffer
+inline void dump_json(const nlohmann::json& doc, std::vector<uint8_t>& buffer) {
+    JsonTextOutput output(buffer);
+    // 别名构造的 shared_ptr 不持有 output，也不分配控制块
+    nlohmann::detail::output_adapter_t<char> adapter(std::shared_ptr<void>(), &output);
+    nlohmann::detail::serializer<nlohmann::json> serializer(adapter, ' ');
+    serializer.dump(doc, false, false, 0);
+}
+
+// 编码到 buffer (清空后写入，保留容量以便复用)
+inline bool encode_json(const nlohmann::json& doc, ContentType content_type, std::vector<uint8_t>& buffer) {
+    buffer.clear();
+    switch (content_type) {
+    case ContentType::Cbor:
+        nlohmann::json::to_cbor(doc, buffer);
+        return true;
+    case ContentType::MsgPack:
+        nlohmann::json::to_msgpack(doc, buffer);
+        return true;
+    case ContentType::BJData:
+        nlohmann::json::to_bjdata(doc, buffer);
+        return true;
+    case ContentType::Json:
+    case ContentType::Raw:
+        dump_json(doc, buffer);
+        return true;
+    case ContentType::KeyDict:
+        return false; // 有状态编码，使用 KeyDictEncoder
+    case ContentType::TimeSeries:
+    case ContentType::Columnar:
+    case ContentType::Flat:
+    case ContentType::Array:
+        return false; // 不是 JSON 文档，使用对应的发布类
+    }
+    return false;
+}
+
+// 未标注类型 (Raw) 的负载按 JSON 文本解析，兼容旧版本发布端；KeyDict 需要 KeyDictDecoder。
+// BasicJson 为 nlohmann::json 或 arena_json
+template <typename BasicJson>
+inline bool decode_json(ContentType content_type, const uint8_t* data, size_t size, BasicJson& doc) {
+    // allow_exceptions=false 时，超大长度字段等少数错误仍会抛出异常
+    try {
+        switch (content_type) {
+        case ContentType::Cbor:
+            doc = BasicJson::from_cbor(data, data + size, true, false);
+            break;
+        case ContentType::MsgPack:
+            doc = BasicJson::from_msgpack(data, data + size, true, false);
+            break;
+        case ContentType::BJData:
+            doc = BasicJson::from_bjdata(data, data + size, true, false);
+            break;
+        case ContentType::Json:
+        case ContentType::Raw:
+            doc = BasicJson::parse(data, data + size, nullptr, false);
+            break;
+        default:
+            return false;
+        }
+    } catch (const nlohmann::json::exception&) {
+        return false;
+    }
+    return !doc.is_discarded();
+}
+
+template <typename BasicJson>
+inline bool decode_json(const Message& message, BasicJson& doc) {
+    return decode_json(message.content_type(), message.data(), message.size(), doc);
+}
+
+// 发布单个文档，buffer 由调用方复用
+inline bool publish_json(Publisher& publisher, const std::string& topic, const nlohmann::json& doc,
+                         ContentType content_type, std::vector<uint8_t>& buffer) {
+    if (!encode_json(doc, content_type, buffer)) {
+        return false;
+    }
+    // 文本统一标注为 Json
+    const ContentType sent = content_type == ContentType::Raw ? ContentType::Json : content_type;
+    return publisher.publish(topic, buffer.data(), buffer.size(), sent);
+}
+
+// 键字典编码 (ContentType::KeyDict): 遥测类小消息中键名往往占一半以上字节。
+// 发布端按 Topic 记录根对象的键列表 (schema)，只在 schema 首次出现、变化或每隔 resend_interval
+// 条消息时随消息发送键列表，其余消息只发送 schema id 和值。PUB/SUB 没有连接级状态，
+// 中途加入的订阅端在收到下一次 schema 定义之前无法解码，这些消息被丢弃。
+//
+// 格式: [kind u8] [schema id u32 LE] [kind=1 时: varint 键数, 每个键 varint 长度 + 字节] [值...]
+//   kind 0 只有值，kind 1 带 schema 定义，kind 2 后面整体为 CBOR (根不是对象时)
+//   值: [tag u8] + 内容，tag 见 keydict::Tag
+namespace keydict {
+
+enum Tag : uint8_t {
+    Null = 0,
+    False = 1,
+    True = 2,
+    Unsigned = 3, // varint
+    Negative = 4, // varint(-(v + 1))
+    Float32 = 5,  // 可无损表示为 float 的浮点数
+    Float64 = 6,
+    String = 7,   // varint 长度 + 字节
+    Nested = 8,   // varint 长度 + CBOR，嵌套对象和数组
+};
+
+enum Kind : uint8_t {
+    Values = 0,
+    Definition = 1,
+    Cbor = 2,
+};
+
+inline void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+inline bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (unsigned shift = 0; p < end && shift < 64; shift += 7) {
+        const uint8_t byte = *p++;
+        v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+inline void put_fixed(std::vector<uint8_t>& out, T v) {
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &v, sizeof(T)); // 按小端平台处理
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+inline bool get_fixed(const uint8_t*& p, const uint8_t* end, T& v) {
+    if (static_cast<size_t>(end - p) < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&v, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+}
+
+// 解码出的单个字段值，字符串和嵌套内容直接引用负载
+struct Field {
+    Tag tag = Null;
+    uint64_t u = 0;
+    int64_t i = 0;
+    double f = 0;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+inline void put_value(std::vector<uint8_t>& out, const nlohmann::json& value) {
+    switch (value.type()) {
+    case nlohmann::json::value_t::boolean:
+        out.push_back(value.get<bool>() ? True : False);
+        return;
+    case nlohmann::json::value_t::number_unsigned:
+        out.push_back(Unsigned);
+        put_varint(out, value.get<uint64_t>());
+        return;
+    case nlohmann::json::value_t::number_integer: {
+        const int64_t v = value.get<int64_t>();
+        if (v >= 0) {
+            out.push_back(Unsigned);
+            put_varint(out, static_cast<uint64_t>(v));
+        } else {
+            out.push_back(Negative);
+            put_varint(out, static_cast<uint64_t>(-(v + 1)));
+        }
+        return;
+    }
+    case nlohmann::json::value_t::number_float: {
+        const double v = value.get<double>();
+        // 超出 float 范围的有限值不能转换 (未定义行为)，直接写 Float64
+        if (!std::isfinite(v) || std::fabs(v) <= std::numeric_limits<float>::max()) {
+            const float narrow = static_cast<float>(v);
+            if (static_cast<double>(narrow) == v || std::isnan(v)) {
+                out.push_back(Float32);
+                put_fixed(out, narrow);
+                return;
+            }
+        }
+        out.push_back(Float64);
+        put_fixed(out, v);
+        return;
+    }
+    case nlohmann::json::value_t::string: {
+        const std::string& text = value.get_ref<const std::string&>();
+        out.push_back(String);
+        put_varint(out, text.size());
+        out.insert(out.end(), text.begin(), text.end());
+        return;
+    }
+    case nlohmann::json::value_t::object:
+    case nlohmann::json::value_t::array:
+    case nlohmann::json::value_t::binary: {
+        const std::vector<uint8_t> nested = nlohmann::json::to_cbor(value);
+        out.push_back(Nested);
+        put_varint(out, nested.size());
+        out.insert(out.end(), nested.begin(), nested.end());
+        return;
+    }
+    default:
+        out.push_back(Null);
+        return;
+    }
+}
+
+inline bool get_value(const uint8_t*& p, const uint8_t* end, Field& field) {
+    if (p >= end) {
+        return false;
+    }
+    field = Field();
+    field.tag = static_cast<Tag>(*p++);
+    switch (field.tag) {
+    case Null:
+    case False:
+    case True:
+        return true;
+    case Unsigned:
+        return get_varint(p, end, field.u);
+    case Negative:
+        if (!get_varint(p, end, field.u) || field.u > static_cast<uint64_t>(INT64_MAX)) {
+            return false;
+        }
+        field.i = -static_cast<int64_t>(field.u) - 1;
+        return true;
+    case Float32: {
+        float narrow = 0;
+        if (!get_fixed(p, end, narrow)) {
+            return false;
+        }
+        field.f = narrow;
+        return true;
+    }
+    case Float64:
+        return get_fixed(p, end, field.f);
+    case String:
+    case Nested: {
+        uint64_t size = 0;
+        if (!get_varint(p, end, size) || size > static_cast<uint64_t>(end - p)) {
+            return false;
+        }
+        field.data = p;
+        field.size = static_cast<size_t>(size);
+        p += size;
+        return true;
+    }
+    }
+    return false;
+}
+
+template <typename BasicJson>
+inline bool to_json(const Field& field, BasicJson& value) {
+    switch (field.tag) {
+    case Null: value = nullptr; return true;
+    case False: value = false; return true;
+    case True: value = true; return true;
+    case Unsigned: value = field.u; return true;
+    case Negative: value = field.i; return true;
+    case Float32:
+    case Float64: value = field.f; return true;
+    case String: value = std::string(reinterpret_cast<const char*>(field.data), field.size); return true;
+    case Nested:
+        return decode_json(ContentType::Cbor, field.data, field.size, value);
+    }
+    return false;
+}
+
+} // namespace keydict
+
+class KeyDictEncoder {
+public:
+    explicit KeyDictEncoder(uint32_t resend_interval = 32)
+        : resend_interval_(resend_interval), random_(std::random_device()()) {}
+
+    // 每隔多少条消息重发一次 schema 定义，决定中途加入的订阅端最多丢弃多少条消息
+    void set_resend_interval(uint32_t interval) { resend_interval_ = interval; }
+
+    bool encode(const std::string& topic, const nlohmann::json& doc, std::vector<uint8_t>& out) {
+        out.clear();
+        if (!doc.is_object()) {
+            out.push_back(keydict::Cbor);
+            nlohmann::json::to_cbor(doc, out);
+            return true;
+        }
+
+        Schema& schema = schemas_[topic];
+        bool changed = schema.keys.size() != doc.size();
+        if (!changed) {
+            size_t i = 0;
+            for (auto it = doc.begin(); it != doc.end(); ++it, ++i) {
+                if (it.key() != schema.keys[i]) {
+                    changed = true;
+                    break;
+                }
+            }
+        }
+        if (changed) {
+            schema.keys.clear();
+            for (auto it = doc.begin(); it != doc.end(); ++it) {
+                schema.keys.push_back(it.key());
+            }
+            // 随机 id，多个发布端使用同一 Topic 时也不易冲突
+            schema.id = static_cast<uint32_t>(random_());
+            schema.sent = 0;
+        }
+
+        const bool define = schema.sent == 0 || resend_interval_ == 0 || schema.sent >= resend_interval_;
+        schema.sent = define ? 1 : schema.sent + 1;
+
+        out.push_back(define ? keydict::Definition : keydict::Values);
+        keydict::put_fixed(out, schema.id);
+        if (define) {
+            keydict::put_varint(out, schema.keys.size());
+            for (const std::string& key : schema.keys) {
+                keydict::put_varint(out, key.size());
+                out.insert(out.end(), key.begin(), key.end());
+            }
+        }
+        for (auto it = doc.begin(); it != doc.end(); ++it) {
+            keydict::put_value(out, it.value());
+        }
+        return true;
+    }
+
+private:
+    struct Schema {
+        uint32_t id = 0;
+        uint32_t sent = 0; // 上次发送定义后的消息数
+        std::vector<std::string> keys;
+    };
+
+    uint32_t resend_interval_;
+    std::mt19937 random_;
+    std::map<std::string, Schema> schemas_;
+};
+
+class KeyDictDecoder {
+public:
+    // 按字段回调 visitor(const std::string& key, const keydict::Field& value)，不构建 DOM。
+    // 根不是对象 (kind 2) 时返回 false，此时应使用 decode 得到完整文档
+    template <typename Visitor>
+    bool visit(const std::string& topic, const uint8_t* data, size_t size, Visitor&& visitor) {
+        const uint8_t* p = data;
+        const uint8_t* end = data + size;
+        const std::vector<std::string>* keys = nullptr;
+        if (!read_schema(topic, p, end, keys)) {
+            return false;
+        }
+        keydict::Field field;
+        for (const std::string& key : *keys) {
+            if (!keydict::get_value(p, end, field)) {
+                return false;
+            }
+            visitor(key, field);
+        }
+        return p == end;
+    }
+
+    template <typename BasicJson>
+    bool decode(const std::string& topic, const uint8_t* data, size_t size, BasicJson& doc) {
+        if (size > 0 && data[0] == keydict::Cbor) {
+            return decode_json(ContentType::Cbor, data + 1, size - 1, doc);
+        }
+        doc = BasicJson::object();
+        bool ok = true;
+        const bool complete = visit(topic, data, size, [&doc, &ok](const std::string& key, const keydict::Field& field) {
+            ok = keydict::to_json(field, doc[key]) && ok;
+        });
+        return complete && ok;
+    }
+
+    template <typename BasicJson>
+    bool decode(const Message& message, BasicJson& doc) {
+        return decode(message.topic(), message.data(), message.size(), doc);
+    }
+
+private:
+    static const size_t kMaxSchemas = 256;
+
+    bool read_schema(const std::string& topic, const uint8_t*& p, const uint8_t* end,
+                     const std::vector<std::string>*& keys) {
+        uint32_t id = 0;
+        if (p >= end) {
+            return false;
+        }
+        const uint8_t kind = *p++;
+        if ((kind != keydict::Values && kind != keydict::Definition) || !keydict::get_fixed(p, end, id)) {
+            return false;
+        }
+
+        const auto key = std::make_pair(topic, id);
+        if (kind == keydict::Values) {
+            auto it = schemas_.find(key);
+            if (it == schemas_.end()) {
+                return false; // 尚未收到 schema 定义
+            }
+            keys = &it->second;
+            return true;
+        }
+
+        uint64_t count = 0;
+        if (!keydict::get_varint(p, end, count) || count > static_cast<uint64_t>(end - p)) {
+            return false;
+        }
+        std::vector<std::string> names;
+        names.reserve(static_cast<size_t>(count));
+        for (uint64_t i = 0; i < count; ++i) {
+            uint64_t length = 0;
+            if (!keydict::get_varint(p, end, length) || length > static_cast<uint64_t>(end - p)) {
+                return false;
+            }
+            names.emplace_back(reinterpret_cast<const char*>(p), static_cast<size_t>(length));
+            p += length;
+        }
+
+        auto it = schemas_.find(key);
+        if (it == schemas_.end()) {
+            if (schemas_.size() >= kMaxSchemas) {
+                schemas_.erase(schemas_.begin());
+            }
+            it = schemas_.insert(std::make_pair(key, std::move(names))).first;
+        } else {
+            it->second = std::move(names);
+        }
+        keys = &it->second;
+        return true;
+    }
+
+    std::map<std::pair<std::string, uint32_t>, std::vector<std::string>> schemas_;
+};
+
+// 按块分配的内存区。reset 时整体回收，用于每条消息 (或每批消息) 解码一次 DOM 的场景，
+// 代替 nlohmann::json 解析时成百上千次的小块 malloc/free
+class JsonArena {
+public:
+    explicit JsonArena(size_t block_size = 64 * 1024) : block_size_(block_size), offset_(0), outer_(nullptr) {}
+    ~JsonArena() { release(); }
+
+    JsonArena(const JsonArena&) = delete;
+    JsonArena& operator=(const JsonArena&) = delete;
+
+    void* allocate(size_t size, size_t alignment) {
+        if (!blocks_.empty()) {
+            const size_t aligned = (offset_ + alignment - 1) / alignment * alignment;
+            if (aligned + size <= blocks_.back().size) {
+                offset_ = aligned + size;
+                return blocks_.back().data + aligned;
+            }
+        }
+        // 块起始按 operator new 的默认对齐，足以满足 JSON 节点
+        const size_t capacity = std::max(block_size_, size);
+        blocks_.push_back(Block{static_cast<char*>(::operator new(capacity)), capacity});
+        offset_ = size;
+        return blocks_.back().data;
+    }
+
+    bool owns(const void* p) const {
+        const char* c = static_cast<const char*>(p);
+        for (const Block& block : blocks_) {
+            if (c >= block.data && c < block.data + block.size) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 回收全部内存。上一轮用了多个块时合并为一个，之后同样大小的文档只用一个块
+    void reset() {
+        if (blocks_.size() > 1) {
+            size_t total = 0;
+            for (const Block& block : blocks_) {
+                total += block.size;
+            }
+            release();
+            blocks_.push_back(Block{static_cast<char*>(::operator new(total)), total});
+        }
+        offset_ = 0;
+    }
+
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Block& block : blocks_) {
+            total += block.size;
+        }
+        return total;
+    }
+
+private:
+    friend class ArenaScope;
+    template <typename T>
+    friend class ArenaAllocator;
+
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    void release() {
+        for (const Block& block : blocks_) {
+            ::operator delete(block.data);
+        }
+        blocks_.clear();
+    }
+
+    static JsonArena*& current() {
+        static thread_local JsonArena* arena = nullptr;
+        return arena;
+    }
+
+    size_t block_size_;
+    size_t offset_;
+    std::vector<Block> blocks_;
+    JsonArena* outer_; // 嵌套作用域中外层的 arena
+};
+
+// 作用域内本线程的 arena_json 从 arena 分配。作用域内创建的值须在作用域结束前销毁，
+// 且不能在 arena reset 之后继续使用
+class ArenaScope {
+public:
+    explicit ArenaScope(JsonArena& arena) : arena_(arena) {
+        arena_.outer_ = JsonArena::current();
+        JsonArena::current() = &arena_;
+    }
+    ~ArenaScope() {
+        JsonArena::current() = arena_.outer_;
+        arena_.outer_ = nullptr;
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    JsonArena& arena_;
+};
+
+// nlohmann::basic_json 用默认构造的分配器创建节点，因此分配器无状态，通过线程当前的 arena 分配。
+// 没有 arena 时退回 operator new；释放时 arena 中的内存什么也不做
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        JsonArena* arena = JsonArena::current();
+        if (arena != nullptr) {
+            return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        for (JsonArena* arena = JsonArena::current(); arena != nullptr; arena = arena->outer_) {
+            if (arena->owns(p)) {
+                return;
+            }
+        }
+        ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>&) const { return false; }
+};
+
+// 对象、数组及其节点在 arena 中分配。字符串仍为 std::string，以便 get<std::string>() 与二进制格式
+// 照常使用；不超过 15 字节的键和值在短字符串缓冲区内，不会分配
+using arena_json = nlohmann::basic_json<std::map, std::vector, std::string, bool, std::int64_t, std::uint64_t,
+                                        double, ArenaAllocator>;
+
+// 每次 decode 回收上一个文档的内存后在 arena 中解码，稳定后对象、数组节点不再调用 malloc
+// (解析器自身的缓冲区与超过 15 字节的字符串除外)。doc() 在下一次 decode 之前有效；需要保留时在作用域外复制
+class ArenaJsonDecoder {
+public:
+    explicit ArenaJsonDecoder(size_t block_size = 64 * 1024) : arena_(block_size) {}
+    ~ArenaJsonDecoder() { clear(); }
+
+    // 与 decode_json 使用同一个 nlohmann 解析器，校验规则一致，只是 DOM 节点分配在 arena 中
+    bool decode(const Message& message) {
+        return decode_with([&message](arena_json& doc) { return decode_json(message, doc); });
+    }
+
+    // fill(arena_json&) 在 arena 作用域内执行，返回是否成功
+    template <typename Fill>
+    bool decode_with(Fill&& fill) {
+        clear();
+        ArenaScope scope(arena_);
+        if (!fill(doc_)) {
+            doc_ = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    const arena_json& doc() const { return doc_; }
+    const JsonArena& arena() const { return arena_; }
+
+    void clear() {
+        {
+            ArenaScope scope(arena_);
+            doc_ = nullptr;
+        }
+        arena_.reset();
+    }
+
+private:
+    JsonArena arena_;
+    arena_json doc_;
+};
+
+class JsonPublisher {
+public:
+    JsonPublisher(const std::string& endpoint, Transport transport = Transport::IPC,
+                  ContentType default_type = ContentType::Cbor)
+        : publisher_(endpoint, transport), default_type_(default_type) {}
+    JsonPublisher(const std::string& endpoint, Transport transport, Context& shared_context,
+                  ContentType default_type = ContentType::Cbor)
+        : publisher_(endpoint, transport, shared_context), default_type_(default_type) {}
+
+    // 为指定 Topic 选择编码，例如给 Python 端只保留 JSON 文本
+    void set_content_type(const std::string& topic, ContentType content_type) {
+        content_types_[topic] = content_type;
+    }
+
+    bool publish_json(const std::string& topic, const nlohmann::json& doc) {
+        auto it = content_types_.find(topic);
+        const ContentType content_type = it != content_types_.end() ? it->second : default_type_;
+        if (content_type == ContentType::KeyDict) {
+            return key_dict_.encode(topic, doc, buffer_) &&
+                   publisher_.publish(topic, buffer_.data(), buffer_.size(), ContentType::KeyDict);
+        }
+        return zmq_simple::publish_json(publisher_, topic, doc, content_type, buffer_);
+    }
+
+    Publisher& publisher() { return publisher_; }
+    KeyDictEncoder& key_dict_encoder() { return key_dict_; }
+
+private:
+    Publisher publisher_;
+    ContentType default_type_;
+    std::map<std::string, ContentType> content_types_;
+    std::vector<uint8_t> buffer_; // 复用的编码缓冲区
+    KeyDictEncoder key_dict_;
+};
+
+class JsonSubscriber {
+public:
+    using JsonCallback = std::function<void(const std::string& topic, const nlohmann::json& doc)>;
+    using ArenaJsonCallback = std::function<void(const std::string& topic, const arena_json& doc)>;
+
+    JsonSubscriber(const std::string& endpoint, Transport transport = Transport::IPC)
+        : subscriber_(endpoint, transport) {}
+    JsonSubscriber(const std::string& endpoint, Transport transport, Context& shared_context)
+        : subscriber_(endpoint, transport, shared_context) {}
+
+    bool subscribe(const std::string& topic = "") { return subscriber_.subscribe(topic); }
+    bool unsubscribe(const std::string& topic) { return subscriber_.unsubscribe(topic); }
+
+    // 解码失败的消息被丢弃并返回 false
+    bool receive(std::string& topic, nlohmann::json& doc, int timeout_ms = -1) {
+        Message message;
+        if (!subscriber_.receive(message, timeout_ms) || !decode(message, doc)) {
+            return false;
+        }
+        topic = message.topic();
+        return true;
+    }
+
+    bool start_loop(JsonCallback callback) {
+        return subscriber_.start_message_loop([this, callback](const Message& message) {
+            nlohmann::json doc;
+            if (decode(message, doc)) {
+                callback(message.topic(), doc);
+            }
+        });
+    }
+
+    // 文档在 arena 中解码，回调返回后即失效。回调在 arena 作用域外执行，其中复制的值分配在普通堆上
+    bool start_arena_loop(ArenaJsonCallback callback) {
+        return subscriber_.start_message_loop([this, callback](const Message& message) {
+            // JSON 文本走结构索引直接构建，只有 KeyDict 需要本订阅端的字典状态
+            const bool ok = message.content_type() == ContentType::KeyDict
+                                ? arena_decoder_.decode_with(
+                                      [this, &message](arena_json& doc) { return key_dict_.decode(message, doc); })
+                                : arena_decoder_.decode(message);
+            if (ok) {
+                callback(message.topic(), arena_decoder_.doc());
+            }
+        });
+    }
+
+    void stop_loop() { subscriber_.stop_loop(); }
+
+    Subscriber& subscriber() { return subscriber_; }
+    KeyDictDecoder& key_dict_decoder() { return key_dict_; }
+
+private:
+    template <typename BasicJson>
+    bool decode(const Message& message, BasicJson& doc) {
+        if (message.content_type() == ContentType::KeyDict) {
+            return key_dict_.decode(message, doc);
+        }
+        return decode_json(message, doc);
+    }
+
+    Subscriber subscriber_;
+    KeyDictDecoder key_dict_; // receive 与消息循环不会同时使用
+    ArenaJsonDecoder arena_decoder_;
+};
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_JSON_HPP
@@ -0,0 +1,387 @@
+#ifndef ZMQ_SIMPLE_SAX_HPP
+#define ZMQ_SIMPLE_SAX_HPP
+
+#include "zmq_simple.hpp"
+#include "zmq_simple_json.hpp"
+#include "zmq_simple_view.hpp"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <nlohmann/json.hpp>
+
+namespace zmq_simple {
+namespace sax {
+
+// SAX 事件中的标量值
+struct Scalar {
+    enum Kind { Bool, Int, Uint, Float, String };
+    Kind kind;
+    bool b;
+    int64_t i;
+    uint64_t u;
+    double f;
+    const char* s;
+    size_t n;
+};
+
+namespace detail {
+
+// 负载来自网络，超出成员类型范围的值不能转换 (未定义行为或静默截断)
+template <typename M>
+bool fits(int64_t v, std::true_type) {
+    using Limits = std::numeric_limits<M>;
+    return std::is_signed<M>::value
+               ? v >= static_cast<int64_t>(Limits::min()) && v <= static_cast<int64_t>(Limits::max())
+               : v >= 0 && static_cast<uint64_t>(v) <= static_cast<uint64_t>(Limits::max());
+}
+
+template <typename M>
+bool fits(uint64_t v, std::true_type) {
+    return v <= static_cast<uint64_t>(std::numeric_limits<M>::max());
+}
+
+// 浮点数转整数时截断小数部分，截断后须在范围内
+template <typename M>
+bool fits(double v, std::true_type) {
+    using Limits = std::numeric_limits<M>;
+    const double lower = std::is_signed<M>::value ? static_cast<double>(Limits::min()) : -1.0;
+    const double upper = static_cast<double>(Limits::max()) + 1.0; // 2 的幂，可精确表示
+    return std::is_signed<M>::value ? v >= lower && v < upper : v > lower && v < upper;
+}
+
+// 整数转浮点数总在范围内 (可能舍入)
+template <typename M>
+bool fits(int64_t, std::false_type) {
+    return true;
+}
+
+template <typename M>
+bool fits(uint64_t, std::false_type) {
+    return true;
+}
+
+template <typename M>
+bool fits(double v, std::false_type) {
+    return !std::isfinite(v) || std::fabs(v) <= static_cast<double>(std::numeric_limits<M>::max());
+}
+
+template <typename M, typename V>
+bool convert(M& target, V v) {
+    if (!fits<M>(v, std::is_integral<M>())) {
+        return false;
+    }
+    target = static_cast<M>(v);
+    return true;
+}
+
+} // namespace detail
+
+// 数值字段: 接受任意数值，直接转换，不分配内存。超出成员类型范围的值被跳过
+template <typename M>
+typename std::enable_if<std::is_arithmetic<M>::value && !std::is_same<M, bool>::value, bool>::type
+assign(M& target, const Scalar& v) {
+    switch (v.kind) {
+    case Scalar::Int: return detail::convert(target, v.i);
+    case Scalar::Uint: return detail::convert(target, v.u);
+    case Scalar::Float: return detail::convert(target, v.f);
+    default: return false;
+    }
+}
+
+inline bool assign(bool& target, const Scalar& v) {
+    if (v.kind != Scalar::Bool) {
+        return false;
+    }
+    target = v.b;
+    return true;
+}
+
+// 字符串字段复制而不是移动，解析器的缓冲区和字段已有容量都可以复用
+inline bool assign(std::string& target, const Scalar& v) {
+    if (v.kind != Scalar::String) {
+        return false;
+    }
+    target.assign(v.s, v.n);
+    return true;
+}
+
+// 其他类型 (嵌套对象、数组等) 不支持，对应的值被跳过
+template <typename M>
+typename std::enable_if<!std::is_arithmetic<M>::value && !std::is_same<M, std::string>::value, bool>::type
+assign(M&, const Scalar&) {
+    return false;
+}
+
+template <typename M>
+void write(nlohmann::json& doc, const char* name, const M& value) {
+    doc[name] = value;
+}
+
+template <typename Owner>
+struct Field {
+    const char* name;
+    size_t length;
+    bool (*assign)(Owner&, const Scalar&);
+    void (*write)(const Owner&, nlohmann::json&, const char*);
+};
+
+template <typename Owner, typename M, M Owner::*Member>
+bool assign_member(Owner& owner, const Scalar& v) {
+    return sax::assign(owner.*Member, v);
+}
+
+template <typename Owner, typename M, M Owner::*Member>
+void write_member(const Owner& owner, nlohmann::json& doc, const char* name) {
+    sax::write(doc, name, owner.*Member);
+}
+
+template <typename T>
+const Field<T>* find_field(const char* name, size_t length) {
+    const auto& fields = T::zmq_simple_sax_fields();
+    for (size_t i = 0; i < fields.second; ++i) {
+        const Field<T>& f = fields.first[i];
+        if (f.length == length && std::memcmp(f.name, name, length) == 0) {
+            return &f;
+        }
+    }
+    return nullptr;
+}
+
+// 只处理根对象的直接成员，按字段表赋值；未知键和嵌套内容跳过
+template <typename T>
+class Handler {
+public:
+    using string_t = nlohmann::json::string_t;
+    using binary_t = nlohmann::json::binary_t;
+
+    explicit Handler(T& target) : target_(target), depth_(0), field_(nullptr) {}
+
+    bool null() { field_ = nullptr; return true; }
+    bool boolean(bool val) { Scalar v{Scalar::Bool, val, 0, 0, 0.0, nullptr, 0}; return set(v); }
+    bool number_integer(int64_t val) { Scalar v{Scalar::Int, false, val, 0, 0.0, nullptr, 0}; return set(v); }
+    bool number_unsigned(uint64_t val) { Scalar v{Scalar::Uint, false, 0, val, 0.0, nullptr, 0}; return set(v); }
+    bool number_float(double val, const string_t&) { Scalar v{Scalar::Float, false, 0, 0, val, nullptr, 0}; return set(v); }
+    bool string(string_t& val) { Scalar v{Scalar::String, false, 0, 0, 0.0, val.data(), val.size()}; return set(v); }
+    bool binary(binary_t&) { field_ = nullptr; return true; }
+
+    bool start_object(std::size_t) { ++depth_; field_ = nullptr; return true; }
+    bool end_object() { --depth_; return true; }
+    bool start_array(std::size_t) { ++depth_; field_ = nullptr; return true; }
+    bool end_array() { --depth_; return true; }
+
+    bool key(string_t& val) {
+        field_ = nullptr;
+        if (depth_ != 1) {
+            return true;
+        }
+        field_ = find_field<T>(val.data(), val.size());
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) { return false; }
+
+private:
+    bool set(const Scalar& v) {
+        if (depth_ == 1 && field_ != nullptr) {
+            field_->assign(target_, v);
+        }
+        field_ = nullptr;
+        return true;
+    }
+
+    T& target_;
+    int depth_;
+    const Field<T>* field_;
+};
+
+inline nlohmann::json::input_format_t input_format(ContentType content_type) {
+    switch (content_type) {
+    case ContentType::Cbor: return nlohmann::json::input_format_t::cbor;
+    case ContentType::MsgPack: return nlohmann::json::input_format_t::msgpack;
+    case ContentType::BJData: return nlohmann::json::input_format_t::bjdata;
+    default: return nlohmann::json::input_format_t::json;
+    }
+}
+
+// 结构索引中的值转为 Scalar，转义字符串还原到 text 中
+inline bool to_scalar(const JsonView::Value& item, Scalar& v, std::string& text) {
+    v = Scalar{Scalar::Bool, false, 0, 0, 0.0, nullptr, 0};
+    switch (item.kind) {
+    case JsonView::Kind::True:
+    case JsonView::Kind::False:
+        v.b = item.kind == JsonView::Kind::True;
+        return true;
+    case JsonView::Kind::String:
+        v.kind = Scalar::String;
+        if (item.has_escapes()) {
+            if (!item.to_string(text)) {
+                return false;
+            }
+            v.s = text.data();
+            v.n = text.size();
+        } else {
+            v.s = item.data;
+            v.n = item.size;
+        }
+        return true;
+    case JsonView::Kind::Number:
+        // 超出 64 位整数范围时按浮点数处理，与 nlohmann 一致
+        if (item.is_integer()) {
+            v.kind = item.data[0] == '-' ? Scalar::Int : Scalar::Uint;
+            if (v.kind == Scalar::Int ? item.to_int(v.i) : item.to_uint(v.u)) {
+                return true;
+            }
+        }
+        v.kind = Scalar::Float;
+        return item.to_double(v.f);
+    default:
+        return false; // null、嵌套对象和数组跳过
+    }
+}
+
+// JSON 文本走结构索引: 一次遍历根对象成员，按字段表直接赋值
+template <typename T>
+bool decode_indexed(const uint8_t* data, size_t size, T& value) {
+    // 每个线程复用一份索引空间
+    static thread_local JsonView view;
+    static thread_local std::string text;
+
+    JsonView::Value root;
+    if (!view.reset(data, size) || !view.root(root) || root.kind != JsonView::Kind::Object) {
+        return false;
+    }
+
+    JsonView::Value key;
+    JsonView::Value item;
+    Scalar v;
+    size_t cursor = 0;
+    while (view.next_member(root, cursor, key, item)) {
+        const Field<T>* field = nullptr;
+        if (key.has_escapes()) {
+            std::string name;
+            if (key.to_string(name)) {
+                field = find_field<T>(name.data(), name.size());
+            }
+        } else {
+            field = find_field<T>(key.data, key.size);
+        }
+        if (field != nullptr && to_scalar(item, v, text)) {
+            field->assign(value, v);
+        }
+    }
+    return view.at_end(root, cursor);
+}
+
+// 键字典编码的字段转为 Scalar
+inline bool to_scalar(const keydict::Field& field, Scalar& v) {
+    v = Scalar{Scalar::Bool, false, 0, 0, 0.0, nullptr, 0};
+    switch (field.tag) {
+    case keydict::False:
+    case keydict::True:
+        v.b = field.tag == keydict::True;
+        return true;
+    case keydict::Unsigned:
+        v.kind = Scalar::Uint;
+        v.u = field.u;
+        return true;
+    case keydict::Negative:
+        v.kind = Scalar::Int;
+        v.i = field.i;
+        return true;
+    case keydict::Float32:
+    case keydict::Float64:
+        v.kind = Scalar::Float;
+        v.f = field.f;
+        return true;
+    case keydict::String:
+        v.kind = Scalar::String;
+        v.s = reinterpret_cast<const char*>(field.data);
+        v.n = field.size;
+        return true;
+    default:
+        return false; // null 与嵌套内容跳过
+    }
+}
+
+} // namespace sax
+
+// 不构建 DOM，直接从负载解析到结构体。JSON 文本经 SIMD 结构索引定位字段，
+// CBOR/MsgPack/BJData 使用 nlohmann 的 SAX 接口
+template <typename T>
+bool decode_sax(const uint8_t* data, size_t size, T& value, ContentType content_type = ContentType::Json) {
+    if (content_type == ContentType::Json || content_type == ContentType::Raw) {
+        return sax::decode_indexed(data, size, value);
+    }
+    sax::Handler<T> handler(value);
+    return nlohmann::json::sax_parse(data, data + size, &handler, sax::input_format(content_type));
+}
+
+template <typename T>
+bool decode_sax(const Message& message, T& value) {
+    return decode_sax(message.data(), message.size(), value, message.content_type());
+}
+
+// 键字典编码的消息 (ContentType::KeyDict) 按 schema 直接赋值，decoder 保存各 Topic 的 schema
+template <typename T>
+bool decode_sax(KeyDictDecoder& decoder, const Message& message, T& value) {
+    if (message.content_type() != ContentType::KeyDict) {
+        return decode_sax(message, value);
+    }
+    sax::Scalar v;
+    return decoder.visit(message.topic(), message.data(), message.size(),
+                         [&value, &v](const std::string& key, const keydict::Field& field) {
+                             const sax::Field<T>* f = sax::find_field<T>(key.data(), key.size());
+                             if (f != nullptr && sax::to_scalar(field, v)) {
+                                 f->assign(value, v);
+                             }
+                         });
+}
+
+template <typename T>
+nlohmann::json encode_sax_fields(const T& value) {
+    nlohmann::json doc = nlohmann::json::object();
+    const auto& fields = T::zmq_simple_sax_fields();
+    for (size_t i = 0; i < fields.second; ++i) {
+        fields.first[i].write(value, doc, fields.first[i].name);
+    }
+    return doc;
+}
+
+// 与 zmq_simple_typed.hpp 配合: template <> struct Serializer<T> : SaxSerializer<T> {};
+template <typename T>
+struct SaxSerializer {
+    static bool publish(Publisher& publisher, const std::string& topic, const T& value, std::vector<uint8_t>& buffer) {
+        return publish_json(publisher, topic, encode_sax_fields(value), ContentType::Json, buffer);
+    }
+
+    static bool decode(const uint8_t* data, size_t size, T& value) {
+        return decode_sax(data, size, value);
+    }
+};
+
+} // namespace zmq_simple
+
+#define ZMQ_SIMPLE_SAX_FIELD(field)                                                                   \
+    ::zmq_simple::sax::Field<zmq_simple_sax_type>{                                                    \
+        #field, sizeof(#field) - 1,                                                                   \
+        &::zmq_simple::sax::assign_member<zmq_simple_sax_type, decltype(zmq_simple_sax_type::field),  \
+                                          &zmq_simple_sax_type::field>,                               \
+        &::zmq_simple::sax::write_member<zmq_simple_sax_type, decltype(zmq_simple_sax_type::field),   \
+                                         &zmq_simple_sax_type::field>},
+
+// 在结构体内部登记可由 decode_sax 解析的字段，用法同 NLOHMANN_DEFINE_TYPE_INTRUSIVE:
+//   struct Sensor { std::string sensor_id; double temperature;
+//                   ZMQ_SIMPLE_DEFINE_SAX_INTRUSIVE(Sensor, sensor_id, temperature) };
+#define ZMQ_SIMPLE_DEFINE_SAX_INTRUSIVE(Type, ...)                                                    \
+    using zmq_simple_sax_type = Type;                                                                 \
+    static const std::pair<const ::zmq_simple::sax::Field<Type>*, size_t>& zmq_simple_sax_fields() {  \
+        static const ::zmq_simple::sax::Field<Type> fields[] = {                                      \
+            NLOHMANN_JSON_EXPAND(NLOHMANN_JSON_PASTE(ZMQ_SIMPLE_SAX_FIELD, __VA_ARGS__))};             \
+        static const std::pair<const ::zmq_simple::sax::Field<Type>*, size_t> table(                  \
+            fields, sizeof(fields) / sizeof(fields[0]));                                              \
+        return table;                                                                                 \
+    }
+
+#endif // ZMQ_SIMPLE_SAX_HPP
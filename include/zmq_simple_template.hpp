@@ -0,0 +1,181 @@
+#ifndef ZMQ_SIMPLE_TEMPLATE_HPP
+#define ZMQ_SIMPLE_TEMPLATE_HPP
+
+#include "zmq_simple.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace zmq_simple {
+
+// 预序列化的 JSON 消息模板。模板文本只解析一次，变化的字段以 ${name:width} 预留定宽槽位，
+// 每次发布只改写槽位，不构建 DOM、不重新序列化:
+//   MessageTemplate t("{\"name\":\"A\",\"count\":${count:12}}");
+//   t.set("count", n);
+//   t.publish(publisher, "app_a_data");
+// 值写在槽位开头，剩余部分以空格填充 (JSON 允许值后的空白)。字符串值连同引号写入槽位，
+// 因此模板中槽位两侧不加引号。槽宽至少为 4 (未设置时为 null)，值超出槽宽时 set 返回 false，槽位保持原值
+class MessageTemplate {
+public:
+    explicit MessageTemplate(const std::string& text) {
+        size_t pos = 0;
+        while (true) {
+            const size_t begin = text.find("${", pos);
+            if (begin == std::string::npos) {
+                buffer_.insert(buffer_.end(), text.begin() + pos, text.end());
+                break;
+            }
+            const size_t colon = text.find(':', begin);
+            const size_t end = text.find('}', begin);
+            if (colon == std::string::npos || end == std::string::npos || colon > end || colon == begin + 2) {
+                throw std::runtime_error("Invalid template slot at offset " + std::to_string(begin));
+            }
+
+            Slot slot;
+            slot.name = text.substr(begin + 2, colon - begin - 2);
+            slot.width = 0;
+            for (size_t i = colon + 1; i < end; ++i) {
+                if (text[i] < '0' || text[i] > '9') {
+                    throw std::runtime_error("Invalid template slot width: " + slot.name);
+                }
+                slot.width = slot.width * 10 + static_cast<size_t>(text[i] - '0');
+            }
+            if (slot.width < 4 || find(slot.name) != kNoSlot) {
+                throw std::runtime_error("Invalid template slot: " + slot.name);
+            }
+
+            buffer_.insert(buffer_.end(), text.begin() + pos, text.begin() + begin);
+            slot.offset = buffer_.size();
+            // 未设置的槽位默认为 null
+            buffer_.insert(buffer_.end(), slot.width, ' ');
+            std::memcpy(buffer_.data() + slot.offset, "null", std::min<size_t>(4, slot.width));
+            slots_.push_back(slot);
+            pos = end + 1;
+        }
+    }
+
+    // 槽位序号，高频发布时可先取得序号再按序号设置，避免按名字查找
+    size_t slot(const std::string& name) const {
+        const size_t index = find(name);
+        if (index == kNoSlot) {
+            throw std::runtime_error("Unknown template slot: " + name);
+        }
+        return index;
+    }
+
+    bool set(size_t index, int64_t value) {
+        char text[24];
+        const int n = std::snprintf(text, sizeof(text), "%lld", static_cast<long long>(value));
+        return set_raw(index, text, static_cast<size_t>(n));
+    }
+
+    bool set(size_t index, uint64_t value) {
+        char text[24];
+        const int n = std::snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(value));
+        return set_raw(index, text, static_cast<size_t>(n));
+    }
+
+    bool set(size_t index, int value) { return set(index, static_cast<int64_t>(value)); }
+
+    bool set(size_t index, double value) {
+        if (!std::isfinite(value)) {
+            return false; // JSON 不能表示 inf/nan
+        }
+        // 优先用较短的 15 位有效数字，不能精确还原时再用 17 位
+        char text[32];
+        int n = std::snprintf(text, sizeof(text), "%.15g", value);
+        if (std::strtod(text, nullptr) != value) {
+            n = std::snprintf(text, sizeof(text), "%.17g", value);
+        }
+        return set_raw(index, text, static_cast<size_t>(n));
+    }
+
+    bool set(size_t index, bool value) {
+        return value ? set_raw(index, "true", 4) : set_raw(index, "false", 5);
+    }
+
+    // 字符串按 JSON 规则转义并加引号
+    bool set(size_t index, const std::string& value) {
+        if (index >= slots_.size()) {
+            return false;
+        }
+        scratch_.clear();
+        scratch_ += '"';
+        for (char c : value) {
+            switch (c) {
+            case '"': scratch_ += "\\\""; break;
+            case '\\': scratch_ += "\\\\"; break;
+            case '\n': scratch_ += "\\n"; break;
+            case '\r': scratch_ += "\\r"; break;
+            case '\t': scratch_ += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                    scratch_ += escaped;
+                } else {
+                    scratch_ += c;
+                }
+            }
+        }
+        scratch_ += '"';
+        return set_raw(index, scratch_.data(), scratch_.size());
+    }
+
+    bool set(size_t index, const char* value) { return set(index, std::string(value)); }
+
+    // 按名字设置，便于低频场景
+    template <typename V>
+    bool set(const std::string& name, const V& value) {
+        const size_t index = find(name);
+        return index != kNoSlot && set(index, value);
+    }
+
+    // 写入已序列化的 JSON 片段 (调用方保证其合法)
+    bool set_raw(size_t index, const char* text, size_t size) {
+        if (index >= slots_.size() || size > slots_[index].width) {
+            return false;
+        }
+        uint8_t* slot = buffer_.data() + slots_[index].offset;
+        std::memcpy(slot, text, size);
+        std::memset(slot + size, ' ', slots_[index].width - size);
+        return true;
+    }
+
+    const uint8_t* data() const { return buffer_.data(); }
+    size_t size() const { return buffer_.size(); }
+    std::string str() const { return std::string(buffer_.begin(), buffer_.end()); }
+
+    bool publish(Publisher& publisher, const std::string& topic) const {
+        return publisher.publish(topic, buffer_.data(), buffer_.size(), ContentType::Json);
+    }
+
+private:
+    static const size_t kNoSlot = static_cast<size_t>(-1);
+
+    struct Slot {
+        std::string name;
+        size_t offset;
+        size_t width;
+    };
+
+    size_t find(const std::string& name) const {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            if (slots_[i].name == name) {
+                return i;
+            }
+        }
+        return kNoSlot;
+    }
+
+    std::vector<uint8_t> buffer_; // 渲染好的消息，发布时直接发送
+    std::vector<Slot> slots_;
+    std::string scratch_;         // 字符串转义的复用缓冲区
+};
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_TEMPLATE_HPP
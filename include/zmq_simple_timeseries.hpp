@@ -0,0 +1,99 @@
+#ifndef ZMQ_SIMPLE_TIMESERIES_HPP
+#define ZMQ_SIMPLE_TIMESERIES_HPP
+
+#include "zmq_simple.hpp"
+#include <chrono>
+#include <map>
+
+namespace zmq_simple {
+
+// 时间序列通道 (ContentType::TimeSeries): 高频数值样本按序列缓冲一小段时间，
+// 以 Gorilla 方式编码成块后发送——时间戳取二阶差分，浮点值与前一个值异或后只写有效位。
+// 采样间隔固定时每个时间戳约 1 比特，缓变的测量值通常每个 1~2 字节:
+//   TimeSeriesPublisher ts(pub, "sensor_ts");
+//   ts.append("temperature", timestamp_ms, 23.5);
+//   ts.append("humidity", timestamp_ms, 45.2);
+// 订阅端用 decode_time_series 还原为各序列的时间戳与数值数组
+struct TimeSeriesOptions {
+    size_t max_samples = 256;  // 任一序列缓冲到该数量时发送
+    int max_delay_ms = 1000;   // 最早的样本缓冲超过该时间时发送 (在 append 时检查)
+};
+
+struct TimeSeries {
+    std::string name;
+    std::vector<int64_t> timestamps; // 单位由应用约定
+    std::vector<double> values;
+};
+
+// 编码一个块，out 清空后写入
+void encode_time_series(const std::vector<TimeSeries>& series, std::vector<uint8_t>& out);
+
+// series 中已有的元素及其数组容量会被复用。数据无效时返回 false
+bool decode_time_series(const uint8_t* data, size_t size, std::vector<TimeSeries>& series);
+bool decode_time_series(const Message& message, std::vector<TimeSeries>& series);
+
+// 同一个块中的序列一同发送，Topic 固定
+class TimeSeriesPublisher {
+public:
+    TimeSeriesPublisher(Publisher& publisher, const std::string& topic,
+                        const TimeSeriesOptions& options = TimeSeriesOptions())
+        : publisher_(publisher), topic_(topic), options_(options), pending_(0) {}
+
+    ~TimeSeriesPublisher() { flush(); }
+
+    TimeSeriesPublisher(const TimeSeriesPublisher&) = delete;
+    TimeSeriesPublisher& operator=(const TimeSeriesPublisher&) = delete;
+
+    // 同一序列的时间戳应单调不减；达到发送条件时在此发送，返回发送结果
+    bool append(const std::string& series, int64_t timestamp, double value) {
+        auto it = index_.find(series);
+        if (it == index_.end()) {
+            it = index_.insert(std::make_pair(series, series_.size())).first;
+            series_.push_back(TimeSeries());
+            series_.back().name = series;
+        }
+        TimeSeries& target = series_[it->second];
+        if (pending_ == 0) {
+            first_sample_ = std::chrono::steady_clock::now();
+        }
+        target.timestamps.push_back(timestamp);
+        target.values.push_back(value);
+        ++pending_;
+
+        if (target.values.size() >= options_.max_samples ||
+            std::chrono::steady_clock::now() - first_sample_ >= std::chrono::milliseconds(options_.max_delay_ms)) {
+            return flush();
+        }
+        return true;
+    }
+
+    // 发送缓冲的样本，没有样本时不发送
+    bool flush() {
+        if (pending_ == 0) {
+            return true;
+        }
+        encode_time_series(series_, buffer_);
+        for (TimeSeries& s : series_) {
+            s.timestamps.clear();
+            s.values.clear();
+        }
+        pending_ = 0;
+        return publisher_.publish(topic_, buffer_.data(), buffer_.size(), ContentType::TimeSeries);
+    }
+
+    size_t pending() const { return pending_; }
+
+private:
+    Publisher& publisher_;
+    std::string topic_;
+    TimeSeriesOptions options_;
+    std::vector<TimeSeries> series_;         // 按首次出现的顺序，清空后保留容量
+    std::map<std::string, size_t> index_;
+    size_t pending_;
+    std::chrono::steady_clock::time_point first_sample_;
+    std::vector<uint8_t> buffer_;
+};
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_TIMESERIES_HPP
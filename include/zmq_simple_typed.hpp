@@ -0,0 +1,197 @@
+#ifndef ZMQ_SIMPLE_TYPED_HPP
+#define ZMQ_SIMPLE_TYPED_HPP
+
+#include "zmq_simple.hpp"
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+#if defined(__has_include)
+#if __has_include(<nlohmann/json.hpp>)
+#include "zmq_simple_json.hpp"
+#define ZMQ_SIMPLE_HAS_NLOHMANN_JSON 1
+#endif
+#endif
+
+namespace zmq_simple {
+
+// 编解码在编译期由 Serializer<T> 决定:
+//   平凡可复制类型 -> RawSerializer，直接按内存布局传输
+//   其他类型       -> JsonSerializer，使用 nlohmann 的 to_json/from_json
+// 需要 CBOR 时特化: template <> struct Serializer<MyType> : CborSerializer<MyType> {};
+
+template <typename T>
+struct RawSerializer {
+    static_assert(std::is_trivially_copyable<T>::value, "RawSerializer requires a trivially copyable type");
+
+    static bool publish(Publisher& publisher, const std::string& topic, const T& value, std::vector<uint8_t>&) {
+        return publisher.publish(topic, &value, sizeof(T));
+    }
+
+    static bool decode(const uint8_t* data, size_t size, T& value) {
+        if (size != sizeof(T)) {
+            return false;
+        }
+        // 接收缓冲区不保证按 T 对齐，复制出来
+        std::memcpy(&value, data, sizeof(T));
+        return true;
+    }
+};
+
+#ifdef ZMQ_SIMPLE_HAS_NLOHMANN_JSON
+template <typename T>
+struct JsonSerializer {
+    // 标注为 Json，JsonSubscriber 与 Python 端按 content type 解码
+    static bool publish(Publisher& publisher, const std::string& topic, const T& value, std::vector<uint8_t>& buffer) {
+        buffer.clear();
+        dump_json(nlohmann::json(value), buffer);
+        return publisher.publish(topic, buffer.data(), buffer.size(), ContentType::Json);
+    }
+
+    static bool decode(const uint8_t* data, size_t size, T& value) {
+        nlohmann::json j = nlohmann::json::parse(data, data + size, nullptr, false);
+        if (j.is_discarded()) {
+            return false;
+        }
+        try {
+            j.get_to(value);
+        } catch (const nlohmann::json::exception&) {
+            return false;
+        }
+        return true;
+    }
+};
+
+template <typename T>
+struct CborSerializer {
+    static bool publish(Publisher& publisher, const std::string& topic, const T& value, std::vector<uint8_t>& buffer) {
+        buffer.clear();
+        nlohmann::json::to_cbor(nlohmann::json(value), buffer);
+        return publisher.publish(topic, buffer.data(), buffer.size(), ContentType::Cbor);
+    }
+
+    static bool decode(const uint8_t* data, size_t size, T& value) {
+        nlohmann::json j = nlohmann::json::from_cbor(data, data + size, true, false);
+        if (j.is_discarded()) {
+            return false;
+        }
+        try {
+            j.get_to(value);
+        } catch (const nlohmann::json::exception&) {
+            return false;
+        }
+        return true;
+    }
+};
+
+template <typename T, typename Enable = void>
+struct Serializer : JsonSerializer<T> {};
+#else
+template <typename T, typename Enable = void>
+struct Serializer; // 非平凡类型需要 nlohmann/json 或自行特化
+#endif
+
+template <typename T>
+struct Serializer<T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type> : RawSerializer<T> {};
+
+template <typename T>
+class TypedPublisher {
+public:
+    TypedPublisher(const std::string& endpoint, Transport transport = Transport::IPC)
+        : publisher_(endpoint, transport) {}
+    TypedPublisher(const std::string& endpoint, Transport transport, Context& shared_context)
+        : publisher_(endpoint, transport, shared_context) {}
+
+    bool publish(const std::string& topic, const T& value) {
+        return Serializer<T>::publish(publisher_, topic, value, buffer_);
+    }
+
+    Publisher& publisher() { return publisher_; }
+
+private:
+    Publisher publisher_;
+    std::vector<uint8_t> buffer_; // 复用的编码缓冲区
+};
+
+// Handler 作为模板参数保存，调用可以被内联，热路径上没有 std::function
+// Handler 签名: void(const std::string& topic, const T& value)
+template <typename T, typename Handler>
+class TypedSubscriber {
+public:
+    TypedSubscriber(const std::string& endpoint, Transport transport, Handler handler)
+        : subscriber_(endpoint, transport), handler_(std::move(handler)), running_(false) {}
+    TypedSubscriber(const std::string& endpoint, Transport transport, Context& shared_context, Handler handler)
+        : subscriber_(endpoint, transport, shared_context), handler_(std::move(handler)), running_(false) {}
+
+    ~TypedSubscriber() { stop_loop(); }
+
+    TypedSubscriber(const TypedSubscriber&) = delete;
+    TypedSubscriber& operator=(const TypedSubscriber&) = delete;
+
+    bool subscribe(const std::string& topic = "") { return subscriber_.subscribe(topic); }
+    bool unsubscribe(const std::string& topic) { return subscriber_.unsubscribe(topic); }
+
+    // 接收一条消息并交给 handler，解码失败的消息被丢弃并返回 false
+    bool receive(int timeout_ms = -1) {
+        Message message;
+        if (!subscriber_.receive(message, timeout_ms)) {
+            return false;
+        }
+        T value;
+        if (!Serializer<T>::decode(message.data(), message.size(), value)) {
+            return false;
+        }
+        handler_(message.topic(), value);
+        return true;
+    }
+
+    bool start_loop() {
+        if (running_) {
+            return false;
+        }
+        running_ = true;
+        thread_ = std::thread([this]() {
+            while (running_) {
+                receive(100); // 100ms 超时以检查 running_ 标志
+            }
+        });
+        return true;
+    }
+
+    void stop_loop() {
+        if (running_) {
+            running_ = false;
+            if (thread_.joinable()) {
+                thread_.join();
+            }
+        }
+    }
+
+    Subscriber& subscriber() { return subscriber_; }
+
+private:
+    Subscriber subscriber_;
+    Handler handler_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
+
+// C++14 下推导 Handler 类型
+template <typename T, typename Handler>
+std::unique_ptr<TypedSubscriber<T, Handler>> make_typed_subscriber(const std::string& endpoint, Transport transport,
+                                                                   Handler handler) {
+    return std::unique_ptr<TypedSubscriber<T, Handler>>(
+        new TypedSubscriber<T, Handler>(endpoint, transport, std::move(handler)));
+}
+
+template <typename T, typename Handler>
+std::unique_ptr<TypedSubscriber<T, Handler>> make_typed_subscriber(const std::string& endpoint, Transport transport,
+                                                                   Context& shared_context, Handler handler) {
+    return std::unique_ptr<TypedSubscriber<T, Handler>>(
+        new TypedSubscriber<T, Handler>(endpoint, transport, shared_context, std::move(handler)));
+}
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_TYPED_HPP
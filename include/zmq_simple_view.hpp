@@ -0,0 +1,78 @@
+#ifndef ZMQ_SIMPLE_VIEW_HPP
+#define ZMQ_SIMPLE_VIEW_HPP
+
+#include "zmq_simple.hpp"
+
+namespace zmq_simple {
+
+// JSON 文本的惰性视图: 先用 SIMD 建立结构索引 (引号、括号、冒号、逗号的位置)，
+// 取字段时沿索引跳转，不构建 DOM，也不复制负载。
+// 只校验定位所需的结构，不保证整个文档合法；视图引用的负载须在使用期间保持有效
+class JsonView {
+public:
+    enum class Kind {
+        String,
+        Number,
+        True,
+        False,
+        Null,
+        Object,
+        Array,
+    };
+
+    struct Value {
+        Kind kind = Kind::Null;
+        const char* data = nullptr; // 字符串不含引号，可能含转义
+        size_t size = 0;
+        size_t entry = 0;           // 对象、数组、字符串在结构索引中的位置
+
+        bool is_integer() const;    // 数字且不含小数点和指数
+        bool to_double(double& value) const;
+        bool to_int(int64_t& value) const;
+        bool to_uint(uint64_t& value) const;
+        bool to_bool(bool& value) const;
+        bool has_escapes() const;
+        bool to_string(std::string& value) const; // 还原转义
+    };
+
+    JsonView();
+    JsonView(const uint8_t* data, size_t size);
+    explicit JsonView(const Message& message);
+
+    // 重新建立索引，复用已分配的索引空间。引号未闭合时返回 false
+    bool reset(const uint8_t* data, size_t size);
+    bool valid() const { return valid_; }
+
+    bool root(Value& value) const;
+    // JSON Pointer 查找，例如 "/sensor/temperature"、"/items/0/id"
+    bool find(const std::string& pointer, Value& value) const;
+    bool find(const Value& object, const char* key, size_t key_size, Value& value) const;
+
+    // 遍历对象成员 / 数组元素，cursor 初始为 0，结束时返回 false
+    bool next_member(const Value& object, size_t& cursor, Value& key, Value& value) const;
+    bool next_element(const Value& array, size_t& cursor, Value& value) const;
+    // 遍历结束后调用: 是否正常到达闭括号 (而不是因结构错误中止)
+    bool at_end(const Value& container, size_t cursor) const;
+
+    // 结构索引中的位置数，便于统计
+    size_t structural_count() const { return count_; }
+
+private:
+    bool value_from(const char* p, size_t entry, Value& value, size_t& next) const;
+    void link_brackets();
+    size_t matching_close(size_t entry) const;
+
+    static const uint32_t kNoClose = UINT32_MAX;
+
+    const char* data_;
+    size_t size_;
+    std::vector<uint32_t> index_;
+    std::vector<uint32_t> close_; // 开括号在索引中的位置 -> 对应闭括号的位置，未闭合为 kNoClose
+    std::vector<uint32_t> stack_;
+    size_t count_;
+    bool valid_;
+};
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_VIEW_HPP
@@ -0,0 +1,39 @@
+#!/usr/bin/env python3
+# numpy 数组通道: 发布端直接引用数组内存，订阅端得到以消息内存为底的只读数组
+# 用法: array_channel.py pub | sub
+import sys
+import time
+from pathlib import Path
+
+import numpy as np
+
+build_path = Path(__file__).parent.parent.parent / "build" / "python"
+sys.path.insert(0, str(build_path))
+
+import zmq_simple
+
+
+def publish():
+    pub = zmq_simple.Publisher("test_array", zmq_simple.Transport.IPC)
+    count = 0
+    while True:
+        # 数组在发送完成前不能修改，每帧使用新的数组
+        frame = np.full((1080, 1920, 3), count % 256, dtype=np.uint8)
+        pub.publish_array("frame", frame)
+        print(f"published frame {count}: {frame.shape} {frame.dtype}")
+        count += 1
+        time.sleep(1)
+
+
+def subscribe():
+    sub = zmq_simple.Subscriber("test_array", zmq_simple.Transport.IPC)
+    sub.subscribe("frame")
+    while True:
+        topic, frame = sub.receive_array(1000)
+        if frame is None:
+            continue
+        print(f"[{topic}] {frame.shape} {frame.dtype} writeable={frame.flags.writeable} mean={frame.mean():.1f}")
+
+
+if __name__ == "__main__":
+    subscribe() if sys.argv[1:] == ["sub"] else publish()
@@ -0,0 +1,41 @@
+#!/usr/bin/env python3
+# 一个事件循环线程同时等待多个订阅端，配合 json_publisher.py 使用
+import sys
+import json
+import asyncio
+from pathlib import Path
+
+build_path = Path(__file__).parent.parent.parent / "build" / "python"
+sys.path.insert(0, str(build_path))
+
+import zmq_simple
+from zmq_simple_asyncio import AsyncSubscriber
+
+
+async def consume(name, sub):
+    async for message in sub:
+        try:
+            print(f"[{name}] {message.topic}: {json.loads(bytes(message))}")
+        except ValueError:
+            print(f"[{name}] {message.topic}: {len(message)} bytes")
+
+
+async def main():
+    endpoints = sys.argv[1:] or ["test_json"]
+    subs = []
+    for endpoint in endpoints:
+        sub = AsyncSubscriber(zmq_simple.Subscriber(endpoint, zmq_simple.Transport.IPC))
+        sub.subscribe("")
+        subs.append(sub)
+    try:
+        await asyncio.gather(*(consume(endpoint, sub) for endpoint, sub in zip(endpoints, subs)))
+    finally:
+        for sub in subs:
+            sub.close()
+
+
+if __name__ == "__main__":
+    try:
+        asyncio.run(main())
+    except KeyboardInterrupt:
+        pass
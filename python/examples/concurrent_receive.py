@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+# 验证阻塞的 receive 不持有 GIL: 两个线程各自在自己的 Subscriber 上 receive，
+# 同时主线程继续发布。持有 GIL 时两个超时会串行叠加，且发布线程无法运行
+import sys
+import time
+import threading
+from pathlib import Path
+
+build_path = Path(__file__).parent.parent.parent / "build" / "python"
+sys.path.insert(0, str(build_path))
+
+import zmq_simple
+
+TIMEOUT_MS = 500
+
+
+def check_timeouts_overlap():
+    subs = [zmq_simple.Subscriber(f"gil_idle_{i}", zmq_simple.Transport.IPC) for i in range(2)]
+    for sub in subs:
+        sub.subscribe("")
+
+    ticks = 0
+    done = threading.Event()
+
+    def ticker():
+        nonlocal ticks
+        while not done.is_set():
+            ticks += 1
+            time.sleep(0.01)
+
+    threads = [threading.Thread(target=sub.receive, args=(TIMEOUT_MS,)) for sub in subs]
+    counter = threading.Thread(target=ticker)
+    start = time.monotonic()
+    counter.start()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    elapsed = time.monotonic() - start
+    done.set()
+    counter.join()
+
+    print(f"two {TIMEOUT_MS} ms receives took {elapsed * 1000:.0f} ms, ticker ran {ticks} times")
+    assert elapsed < 2 * TIMEOUT_MS / 1000 * 0.8, "receive calls were serialized by the GIL"
+    assert ticks >= 10, "other Python threads were blocked during receive"
+
+
+def check_concurrent_delivery():
+    pubs = [zmq_simple.Publisher(f"gil_busy_{i}", zmq_simple.Transport.IPC) for i in range(2)]
+    subs = [zmq_simple.Subscriber(f"gil_busy_{i}", zmq_simple.Transport.IPC) for i in range(2)]
+    for sub in subs:
+        sub.subscribe("")
+    time.sleep(0.2)  # 等待订阅生效
+
+    count = 200
+    received = [0, 0]
+
+    def consume(index):
+        while received[index] < count:
+            topic, _ = subs[index].receive(2000)
+            if not topic:
+                break
+            received[index] += 1
+
+    threads = [threading.Thread(target=consume, args=(i,)) for i in range(2)]
+    for t in threads:
+        t.start()
+    for n in range(count):
+        for pub in pubs:
+            pub.publish_bytes("data", n.to_bytes(4, "little"))
+    for t in threads:
+        t.join()
+
+    print(f"received {received} of {count} per subscriber")
+    assert received == [count, count], "messages were lost while receiving concurrently"
+
+
+def main():
+    check_timeouts_overlap()
+    check_concurrent_delivery()
+    print("OK")
+
+
+if __name__ == "__main__":
+    main()
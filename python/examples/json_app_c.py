@@ -31,38 +31,32 @@ def main():
         sub_a.subscribe("")
         sub_b.subscribe("")
         
-        def on_message_a(topic, data):
-            try:
-                received = json.loads(data.decode('utf-8'))
-                print(f"[A→C] {json.dumps(received)}")
-            except Exception as e:
-                print(f"错误: {e}")
+        # 按 content type 解码 (JSON 文本或 CBOR)，回调直接得到 Python 对象
+        def on_message_a(message):
+            print(f"[A→C] {json.dumps(message.json())}")
         
-        def on_message_b(topic, data):
-            try:
-                received = json.loads(data.decode('utf-8'))
-                print(f"[B→C] {json.dumps(received)}")
-            except Exception as e:
-                print(f"错误: {e}")
+        def on_message_b(message):
+            print(f"[B→C] {json.dumps(message.json())}")
         
-        sub_a.start_loop(on_message_a)
-        sub_b.start_loop(on_message_b)
+        # 两个订阅端由主线程多路等待，不再各自创建接收线程
+        poller = zmq_simple.Poller()
+        poller.register(sub_a, on_message_a)
+        poller.register(sub_b, on_message_b)
         
         toBcount = 0
         toAcount = 0
         while running:
-            time.sleep(3)
+            deadline = time.monotonic() + 3
+            while running and time.monotonic() < deadline:
+                poller.dispatch(int((deadline - time.monotonic()) * 1000) + 1)
             messageA = {"name": "C", "message": "C to A", "count": toAcount}
-            pub.publish("CA", json.dumps(messageA))
+            pub.publish_json("CA", messageA, zmq_simple.ContentType.CBOR)
             print(f"[C Publish to A:] {json.dumps(messageA)}")
             toAcount += 1
             messageB = {"name": "C", "message": "C to B", "count": toBcount}
-            pub.publish("CB", json.dumps(messageB))
+            pub.publish_json("CB", messageB, zmq_simple.ContentType.CBOR)
             print(f"[C Publish to B:] {json.dumps(messageB)}")
             toBcount += 1
-
-        sub_a.stop_loop()
-        sub_b.stop_loop()
     
     except Exception as e:
         print(f"错误: {e}")
@@ -0,0 +1,124 @@
+"""zmq_simple 的 asyncio 适配，订阅端在事件循环线程中等待，不占用额外线程。
+
+    sub = AsyncSubscriber(zmq_simple.Subscriber("test_json"))
+    sub.subscribe("")
+    message = await sub.recv()          # zmq_simple.Message，memoryview(message) 不复制
+    async for message in sub: ...
+
+    pub = AsyncPublisher(zmq_simple.Publisher("test_json"))
+    await pub.send("topic", b"data")
+
+Subscriber.fileno() 是边沿触发的 ZMQ_FD，可读时须一直接收到 readable() 为 False。
+只有存在等待者时才注册 reader，没有人 await 时消息留在 ZeroMQ 队列中，受高水位限制。
+"""
+import asyncio
+import collections
+
+import zmq_simple
+
+
+class AsyncSubscriber:
+    def __init__(self, subscriber):
+        self._sub = subscriber
+        self._fd = subscriber.fileno()
+        self._loop = None
+        self._waiters = collections.deque()
+        self._reading = False
+        self._closed = False
+
+    def subscribe(self, topic=""):
+        return self._sub.subscribe(topic)
+
+    def unsubscribe(self, topic):
+        return self._sub.unsubscribe(topic)
+
+    @property
+    def subscriber(self):
+        return self._sub
+
+    async def recv(self):
+        if self._closed:
+            raise RuntimeError("AsyncSubscriber is closed")
+        if self._loop is None:
+            self._loop = asyncio.get_running_loop()
+
+        # 没有排队的等待者时先直接取，已到达的消息不经过事件循环
+        if not self._waiters:
+            message = self._sub.receive_message(0)
+            if message is not None:
+                return message
+
+        waiter = self._loop.create_future()
+        self._waiters.append(waiter)
+        self._update_reader()
+        try:
+            return await waiter
+        except asyncio.CancelledError:
+            if waiter in self._waiters:
+                self._waiters.remove(waiter)
+            self._update_reader()
+            raise
+
+    def __aiter__(self):
+        return self
+
+    async def __anext__(self):
+        return await self.recv()
+
+    def close(self):
+        if self._closed:
+            return
+        self._closed = True
+        if self._reading:
+            self._loop.remove_reader(self._fd)
+            self._reading = False
+        while self._waiters:
+            waiter = self._waiters.popleft()
+            if not waiter.done():
+                waiter.cancel()
+
+    def _on_readable(self):
+        while not self._closed:
+            while self._waiters and self._waiters[0].done():
+                self._waiters.popleft()  # 已取消
+            if not self._waiters:
+                break
+            message = self._sub.receive_message(0)
+            if message is None:
+                # 数据块、被过滤的消息也会消耗事件，状态仍可读时继续
+                if self._sub.readable():
+                    continue
+                break
+            self._waiters.popleft().set_result(message)
+        self._update_reader()
+
+    def _update_reader(self):
+        if self._closed:
+            return
+        if self._waiters and not self._reading:
+            self._loop.add_reader(self._fd, self._on_readable)
+            self._reading = True
+            # 注册前已到达的消息不会再触发边沿
+            self._loop.call_soon(self._on_readable)
+        elif not self._waiters and self._reading:
+            self._loop.remove_reader(self._fd)
+            self._reading = False
+
+
+class AsyncPublisher:
+    """PUB 发送不会阻塞 (超过高水位时丢弃)，send 直接发送，提供与订阅端一致的 await 接口。"""
+
+    def __init__(self, publisher):
+        self._pub = publisher
+
+    @property
+    def publisher(self):
+        return self._pub
+
+    async def send(self, topic, data, content_type=zmq_simple.ContentType.RAW):
+        if isinstance(data, str):
+            data = data.encode("utf-8")
+        return self._pub.publish(topic, data, content_type)
+
+    async def send_json(self, topic, obj, content_type=zmq_simple.ContentType.CBOR):
+        return self._pub.publish_json(topic, obj, content_type)
@@ -2,9 +2,367 @@
 #include <pybind11/stl.h>
 #include <pybind11/functional.h>
 #include "../include/zmq_simple.hpp"
+#include "../include/zmq_simple_json.hpp"
+#include "../include/zmq_simple_array.hpp"
+#include <atomic>
+#include <mutex>
 
 namespace py = pybind11;
 
+namespace
+{
+    // 阻塞的收发在释放 GIL 后进行。socket 不是线程安全的，GIL 释放后由对象锁保证
+    // 同一个 Publisher/Subscriber 不被多个 Python 线程同时使用
+    class PyPublisher : public zmq_simple::Publisher
+    {
+    public:
+        using zmq_simple::Publisher::Publisher;
+        std::mutex mutex;
+    };
+
+    class PySubscriber : public zmq_simple::Subscriber
+    {
+    public:
+        using zmq_simple::Subscriber::Subscriber;
+        std::mutex mutex;
+    };
+
+    // 析构会 join 接收线程或等待 ZeroMQ 线程退出 (zmq_ctx_destroy)，而这些线程可能正在等待 GIL
+    template <typename T>
+    struct ReleaseGilDelete
+    {
+        void operator()(T *p) const
+        {
+            py::gil_scoped_release release;
+            delete p;
+        }
+    };
+
+    // 释放 GIL 后在对象锁内执行 f。先释放 GIL 再加锁，持锁期间不再获取 GIL，不会死锁
+    template <typename T, typename F>
+    auto without_gil(T &self, F f) -> decltype(f())
+    {
+        py::gil_scoped_release release;
+        std::lock_guard<std::mutex> lock(self.mutex);
+        return f();
+    }
+
+    // ZeroMQ 在 I/O 线程中释放零拷贝帧，不能在那里等待 GIL (Context 析构时还会与持有 GIL 的线程互相等待)。
+    // 没有 GIL 的线程把缓冲区放入队列，由 Py_AddPendingCall 或下一次发布在持有 GIL 时统一释放
+    struct ReleaseQueue
+    {
+        std::mutex mutex;
+        std::vector<Py_buffer *> buffers;
+        std::atomic<bool> scheduled{false};
+    };
+
+    // 不析构，退出时 I/O 线程仍可能访问
+    ReleaseQueue &release_queue()
+    {
+        static ReleaseQueue *queue = new ReleaseQueue();
+        return *queue;
+    }
+
+    // 须持有 GIL
+    void drain_released_buffers()
+    {
+        ReleaseQueue &queue = release_queue();
+        queue.scheduled = false;
+        std::vector<Py_buffer *> buffers;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            buffers.swap(queue.buffers);
+        }
+        for (Py_buffer *b : buffers)
+        {
+            PyBuffer_Release(b);
+            delete b;
+        }
+    }
+
+    int drain_pending_call(void *)
+    {
+        drain_released_buffers();
+        return 0;
+    }
+
+    void release_buffer(Py_buffer *b)
+    {
+        // 解释器退出后无法再释放，此时放弃
+        if (!Py_IsInitialized())
+        {
+            delete b;
+            return;
+        }
+        if (PyGILState_Check())
+        {
+            PyBuffer_Release(b);
+            delete b;
+            return;
+        }
+        ReleaseQueue &queue = release_queue();
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.buffers.push_back(b);
+        }
+        // 待处理调用队列已满时留给下一次发布
+        if (!queue.scheduled.exchange(true) && Py_AddPendingCall(drain_pending_call, nullptr) != 0)
+        {
+            queue.scheduled = false;
+        }
+    }
+
+    // 按缓冲区协议取得连续内存并持有到 ZeroMQ 发送完成，释放可能发生在 I/O 线程
+    std::shared_ptr<Py_buffer> hold_buffer(const py::handle &data, int flags)
+    {
+        drain_released_buffers();
+        std::unique_ptr<Py_buffer> view(new Py_buffer());
+        if (PyObject_GetBuffer(data.ptr(), view.get(), flags) != 0)
+        {
+            throw py::error_already_set();
+        }
+        return std::shared_ptr<Py_buffer>(view.release(), release_buffer);
+    }
+
+    bool publish_buffer(PyPublisher &self, const std::string &topic, const py::buffer &data,
+                        zmq_simple::ContentType content_type)
+    {
+        std::shared_ptr<Py_buffer> view = hold_buffer(data, PyBUF_SIMPLE);
+        const void *ptr = view->buf;
+        const size_t size = static_cast<size_t>(view->len);
+        // 传入副本，复制发送的小负载不会在释放 GIL 期间释放最后一个引用，view 在重新持有 GIL 后才析构
+        return without_gil(self, [&]
+                           { return self.publish_shared(topic, ptr, size, view, content_type); });
+    }
+
+    // 批量发布: 持有 GIL 时取得所有 topic 与缓冲区，之后只释放一次 GIL 依次发送，返回成功条数
+    size_t publish_many(PyPublisher &self, const py::iterable &messages, zmq_simple::ContentType content_type)
+    {
+        struct Item
+        {
+            std::string topic;
+            std::string text; // str 负载按 UTF-8 复制
+            std::shared_ptr<Py_buffer> view;
+        };
+        std::vector<Item> items;
+        if (py::hasattr(messages, "__len__"))
+        {
+            items.reserve(py::len(messages));
+        }
+        for (const py::handle entry : messages)
+        {
+            const py::tuple pair = py::reinterpret_borrow<py::object>(entry).cast<py::tuple>();
+            if (pair.size() != 2)
+            {
+                throw py::value_error("publish_many expects (topic, data) pairs");
+            }
+            Item item;
+            item.topic = pair[0].cast<std::string>();
+            if (py::isinstance<py::str>(pair[1]))
+            {
+                item.text = pair[1].cast<std::string>();
+            }
+            else
+            {
+                item.view = hold_buffer(pair[1], PyBUF_SIMPLE);
+            }
+            items.push_back(std::move(item));
+        }
+
+        // items 保留每个缓冲区的引用，没有被 ZeroMQ 引用的缓冲区在重新持有 GIL 后才释放
+        return without_gil(self, [&]
+                           {
+            size_t sent = 0;
+            for (const Item &item : items) {
+                const bool ok = item.view
+                    ? self.publish_shared(item.topic, item.view->buf, static_cast<size_t>(item.view->len), item.view, content_type)
+                    : self.publish(item.topic, item.text.data(), item.text.size(), content_type);
+                sent += ok ? 1 : 0;
+            }
+            return sent; });
+    }
+
+    // numpy 数组: 连续数组直接引用其内存，dtype、形状与步长放入元数据
+    bool publish_array(PyPublisher &self, const std::string &topic, py::object array)
+    {
+        if (!array.attr("flags").attr("c_contiguous").cast<bool>() &&
+            !array.attr("flags").attr("f_contiguous").cast<bool>())
+        {
+            // 非连续视图先整理为连续，这是唯一的一次复制
+            array = py::module_::import("numpy").attr("ascontiguousarray")(array);
+        }
+        const std::string typestr = array.attr("dtype").attr("str").cast<std::string>();
+        if (typestr.size() < 3 || std::string("biufc").find(typestr[1]) == std::string::npos)
+        {
+            throw py::type_error("publish_array supports bool, integer, float and complex dtypes, got " + typestr);
+        }
+
+        std::shared_ptr<Py_buffer> view = hold_buffer(array, PyBUF_ANY_CONTIGUOUS | PyBUF_STRIDES);
+        zmq_simple::ArrayInfo info;
+        info.byte_order = typestr[0];
+        info.kind = typestr[1];
+        info.itemsize = static_cast<size_t>(view->itemsize);
+        for (int i = 0; i < view->ndim; ++i)
+        {
+            info.shape.push_back(view->shape[i]);
+            // 长度不超过 1 的维度步长没有意义，numpy 可能给出任意值
+            info.strides.push_back(view->shape[i] <= 1 ? 0 : view->strides[i]);
+        }
+        const void *ptr = view->buf;
+        const size_t size = static_cast<size_t>(view->len);
+        return without_gil(self, [&]
+                           { return zmq_simple::publish_array(self, topic, info, ptr, size, view); });
+    }
+
+    // 在消息内存上构造只读 ndarray，数组持有 Message 的引用
+    py::object message_array(const zmq_simple::Message &message)
+    {
+        zmq_simple::ArrayInfo info;
+        if (!zmq_simple::decode_array(message, info))
+        {
+            throw py::value_error("message does not carry an array");
+        }
+        py::module_ numpy = py::module_::import("numpy");
+        return numpy.attr("ndarray")(py::arg("shape") = info.shape, py::arg("dtype") = numpy.attr("dtype")(info.typestr()),
+                                     py::arg("buffer") = py::cast(message), py::arg("strides") = info.strides);
+    }
+
+    py::bytes message_bytes(const zmq_simple::Message &message)
+    {
+        return py::bytes(reinterpret_cast<const char *>(message.data()), message.size());
+    }
+
+    // Python 侧的 Poller，保存 Subscriber 的 Python 对象以保持其存活，序号与 poller 一致。
+    // 只应在一个线程中使用: 等待期间释放了 GIL，其他线程的调用直接报错
+    class PyPoller
+    {
+    public:
+        zmq_simple::Poller poller;
+        std::vector<py::object> subscribers;
+        std::vector<py::object> callbacks; // None 表示只参与 poll，不由 dispatch 接收
+        std::atomic<bool> busy{false};
+    };
+
+    class PollerGuard
+    {
+    public:
+        explicit PollerGuard(PyPoller &poller) : busy_(poller.busy)
+        {
+            if (busy_.exchange(true))
+            {
+                throw std::runtime_error("Poller is already in use by another thread");
+            }
+        }
+        ~PollerGuard() { busy_ = false; }
+
+    private:
+        std::atomic<bool> &busy_;
+    };
+
+    // 交给接收线程的 Python 回调: 复制和析构可能发生在不持有 GIL 的线程，
+    // 引用计数只在 GIL 下修改
+    std::shared_ptr<py::function> hold_callback(py::function callback)
+    {
+        return std::shared_ptr<py::function>(new py::function(std::move(callback)), [](py::function *f)
+                                             {
+                                                 py::gil_scoped_acquire acquire;
+                                                 delete f; });
+    }
+
+    // Python 对象与 nlohmann::json 互转，供 publish_json / receive_json 使用
+    nlohmann::json to_json(const py::handle &obj)
+    {
+        if (obj.is_none())
+        {
+            return nullptr;
+        }
+        if (py::isinstance<py::bool_>(obj))
+        {
+            return obj.cast<bool>();
+        }
+        if (py::isinstance<py::int_>(obj))
+        {
+            return obj.cast<long long>();
+        }
+        if (py::isinstance<py::float_>(obj))
+        {
+            return obj.cast<double>();
+        }
+        if (py::isinstance<py::str>(obj))
+        {
+            return obj.cast<std::string>();
+        }
+        if (py::isinstance<py::bytes>(obj))
+        {
+            const std::string raw = obj.cast<std::string>();
+            return nlohmann::json::binary(std::vector<uint8_t>(raw.begin(), raw.end()));
+        }
+        if (py::isinstance<py::dict>(obj))
+        {
+            nlohmann::json doc = nlohmann::json::object();
+            for (const auto &item : obj.cast<py::dict>())
+            {
+                doc[py::str(item.first).cast<std::string>()] = to_json(item.second);
+            }
+            return doc;
+        }
+        if (py::isinstance<py::list>(obj) || py::isinstance<py::tuple>(obj))
+        {
+            nlohmann::json doc = nlohmann::json::array();
+            for (const auto &item : obj)
+            {
+                doc.push_back(to_json(item));
+            }
+            return doc;
+        }
+        throw py::type_error("Object is not JSON serializable: " + py::repr(obj).cast<std::string>());
+    }
+
+    py::object from_json(const nlohmann::json &doc)
+    {
+        switch (doc.type())
+        {
+        case nlohmann::json::value_t::null:
+            return py::none();
+        case nlohmann::json::value_t::boolean:
+            return py::bool_(doc.get<bool>());
+        case nlohmann::json::value_t::number_integer:
+            return py::int_(doc.get<long long>());
+        case nlohmann::json::value_t::number_unsigned:
+            return py::int_(doc.get<unsigned long long>());
+        case nlohmann::json::value_t::number_float:
+            return py::float_(doc.get<double>());
+        case nlohmann::json::value_t::string:
+            return py::str(doc.get_ref<const std::string &>());
+        case nlohmann::json::value_t::binary:
+        {
+            const auto &bin = doc.get_binary();
+            return py::bytes(reinterpret_cast<const char *>(bin.data()), bin.size());
+        }
+        case nlohmann::json::value_t::array:
+        {
+            py::list list;
+            for (const auto &item : doc)
+            {
+                list.append(from_json(item));
+            }
+            return list;
+        }
+        case nlohmann::json::value_t::object:
+        {
+            py::dict dict;
+            for (auto it = doc.begin(); it != doc.end(); ++it)
+            {
+                dict[py::str(it.key())] = from_json(it.value());
+            }
+            return dict;
+        }
+        default:
+            return py::none();
+        }
+    }
+} // namespace
+
 PYBIND11_MODULE(zmq_simple, m)
 {
     m.doc() = "Simple ZeroMQ pub-sub wrapper for Python";
@@ -14,12 +372,140 @@ PYBIND11_MODULE(zmq_simple, m)
         .value("INPROC", zmq_simple::Transport::INPROC)
         .export_values();
 
+    py::enum_<zmq_simple::ContentType>(m, "ContentType")
+        .value("RAW", zmq_simple::ContentType::Raw)
+        .value("JSON", zmq_simple::ContentType::Json)
+        .value("CBOR", zmq_simple::ContentType::Cbor)
+        .value("MSGPACK", zmq_simple::ContentType::MsgPack)
+        .value("BJDATA", zmq_simple::ContentType::BJData)
+        .value("ARRAY", zmq_simple::ContentType::Array)
+        .export_values();
+
+    m.def("train_compression_dictionary", [](const std::vector<py::bytes> &samples, size_t capacity)
+          {
+              std::vector<std::string> raw(samples.begin(), samples.end());
+              std::vector<uint8_t> dict = zmq_simple::train_compression_dictionary(raw, capacity);
+              return py::bytes(reinterpret_cast<const char*>(dict.data()), dict.size()); }, py::arg("samples"), py::arg("capacity") = 16 * 1024, "Train a compression dictionary from sample payloads");
+
+    // 接收到的消息，按缓冲区协议只读暴露负载: memoryview(message)、numpy.frombuffer(message) 不复制
+    py::class_<zmq_simple::Message>(m, "Message", py::buffer_protocol())
+        .def_property_readonly("topic", &zmq_simple::Message::topic)
+        .def_property_readonly("content_type", &zmq_simple::Message::content_type)
+        .def("__len__", &zmq_simple::Message::size)
+        .def("bytes", &message_bytes, "Copy the payload into a bytes object")
+        .def("array", &message_array, "View an ARRAY message as a read-only numpy array without copying")
+        .def("json", [](const zmq_simple::Message &self)
+             {
+                 nlohmann::json doc;
+                 if (!zmq_simple::decode_json(self, doc)) {
+                     throw py::value_error("message is not a JSON/CBOR/MsgPack/BJData document");
+                 }
+                 return from_json(doc); }, "Decode a JSON/CBOR/MsgPack/BJData payload into Python objects")
+        .def_buffer([](zmq_simple::Message &self)
+                    {
+                        static uint8_t empty = 0;
+                        uint8_t *data = self.data() != nullptr ? const_cast<uint8_t *>(self.data()) : &empty;
+                        return py::buffer_info(data, 1, py::format_descriptor<uint8_t>::format(), 1,
+                                               {static_cast<py::ssize_t>(self.size())}, {1}, true); });
+
+    // 多路等待: 一个线程等待多个 Subscriber，不为每个订阅端创建接收线程
+    py::class_<PyPoller>(m, "Poller")
+        .def(py::init<>())
+        .def("register", [](PyPoller &self, py::object subscriber, py::object callback)
+             {
+                 PollerGuard guard(self);
+                 PySubscriber &native = subscriber.cast<PySubscriber &>();
+                 const size_t index = self.poller.add(native);
+                 if (index == self.subscribers.size()) {
+                     self.subscribers.push_back(subscriber);
+                     self.callbacks.push_back(callback);
+                 } else {
+                     self.callbacks[index] = callback;
+                 } }, py::arg("subscriber"), py::arg("callback") = py::none(), "Add a Subscriber; with a callback its messages are delivered by dispatch() as callback(message)")
+        .def("unregister", [](PyPoller &self, py::object subscriber)
+             {
+                 PollerGuard guard(self);
+                 PySubscriber &native = subscriber.cast<PySubscriber &>();
+                 for (size_t i = 0; i < self.poller.size(); ++i) {
+                     if (&self.poller.at(i) == &native) {
+                         self.poller.remove(native);
+                         self.subscribers.erase(self.subscribers.begin() + i);
+                         self.callbacks.erase(self.callbacks.begin() + i);
+                         return true;
+                     }
+                 }
+                 return false; }, py::arg("subscriber"), "Remove a Subscriber")
+        .def("poll", [](PyPoller &self, int timeout_ms)
+             {
+                 PollerGuard guard(self);
+                 std::vector<size_t> ready;
+                 {
+                     py::gil_scoped_release release;
+                     self.poller.wait(ready, timeout_ms);
+                 }
+                 py::list result;
+                 for (size_t index : ready) {
+                     result.append(self.subscribers[index]);
+                 }
+                 return result; }, py::arg("timeout_ms") = -1, "Wait until at least one Subscriber is readable and return the readable ones (empty list on timeout)")
+        .def("dispatch", [](PyPoller &self, int timeout_ms, size_t max_per_subscriber)
+             {
+                 PollerGuard guard(self);
+                 std::vector<bool> dispatched(self.callbacks.size());
+                 for (size_t i = 0; i < self.callbacks.size(); ++i) {
+                     dispatched[i] = !self.callbacks[i].is_none();
+                 }
+
+                 // 等待与接收只释放一次 GIL，之后在本线程中依次回调
+                 std::vector<std::pair<size_t, zmq_simple::Message>> received;
+                 {
+                     py::gil_scoped_release release;
+                     std::vector<size_t> ready;
+                     self.poller.wait(ready, timeout_ms);
+                     for (size_t index : ready) {
+                         if (!dispatched[index]) {
+                             continue;
+                         }
+                         PySubscriber &subscriber = static_cast<PySubscriber &>(self.poller.at(index));
+                         std::lock_guard<std::mutex> lock(subscriber.mutex);
+                         zmq_simple::Message message;
+                         for (size_t n = 0; n < max_per_subscriber;) {
+                             if (subscriber.receive(message, 0)) {
+                                 received.emplace_back(index, std::move(message));
+                                 ++n;
+                             } else if (!subscriber.readable()) {
+                                 break;
+                             }
+                         }
+                     }
+                 }
+                 // 消息已从 socket 取出，某个回调抛出异常时仍交付其余消息，之后重新抛出第一个异常
+                 std::unique_ptr<py::error_already_set> error;
+                 for (const auto &item : received) {
+                     try {
+                         self.callbacks[item.first](item.second);
+                     } catch (py::error_already_set &e) {
+                         if (!error) {
+                             error.reset(new py::error_already_set(std::move(e)));
+                         }
+                     }
+                 }
+                 if (error) {
+                     throw py::error_already_set(std::move(*error));
+                 }
+                 return received.size(); }, py::arg("timeout_ms") = -1, py::arg("max_per_subscriber") = 1024,
+             "Wait, then deliver pending messages of Subscribers registered with a callback; returns the number delivered. "
+             "If a callback raises, the remaining messages are still delivered and the first exception is re-raised afterwards")
+        .def("__len__", [](const PyPoller &self)
+             { return self.subscribers.size(); });
+
     // 上下文
-    py::class_<zmq_simple::Context>(m, "Context")
+    py::class_<zmq_simple::Context, std::unique_ptr<zmq_simple::Context, ReleaseGilDelete<zmq_simple::Context>>>(
+        m, "Context")
         .def(py::init<>());
 
     // Publisher
-    py::class_<zmq_simple::Publisher>(m, "Publisher")
+    py::class_<PyPublisher, std::unique_ptr<PyPublisher, ReleaseGilDelete<PyPublisher>>>(m, "Publisher")
         .def(py::init<const std::string &, zmq_simple::Transport>(),
              py::arg("endpoint"),
              py::arg("transport") = zmq_simple::Transport::IPC)
@@ -27,19 +513,41 @@ PYBIND11_MODULE(zmq_simple, m)
              py::arg("endpoint"),
              py::arg("transport"),
              py::arg("shared_context"))
-        .def("publish",
-             static_cast<bool (zmq_simple::Publisher::*)(const std::string &, const std::string &)>(
-                 &zmq_simple::Publisher::publish),
-             py::arg("topic"),
-             py::arg("data"),
-             "Publish a message to a topic")
-        .def("publish_bytes", [](zmq_simple::Publisher &self, const std::string &topic, const py::bytes &data)
+        // 支持缓冲区协议的对象 (bytes、bytearray、memoryview、numpy 数组) 不复制，
+        // 可变对象在发送完成前不要修改
+        .def("publish", &publish_buffer, py::arg("topic"), py::arg("data"), py::arg("content_type") = zmq_simple::ContentType::Raw,
+             "Publish a bytes-like object to a topic without copying")
+        .def("publish", [](PyPublisher &self, const std::string &topic, const std::string &data)
+             { return without_gil(self, [&]
+                                  { return self.publish(topic, data); }); }, py::arg("topic"), py::arg("data"), "Publish a message to a topic")
+        .def("publish_many", &publish_many, py::arg("messages"), py::arg("content_type") = zmq_simple::ContentType::Raw,
+             "Publish an iterable of (topic, data) pairs with a single GIL release; returns the number sent")
+        .def("publish_array", &publish_array, py::arg("topic"), py::arg("array"),
+             "Publish a numpy array with its dtype and shape; contiguous arrays are not copied (do not modify until sent)")
+        .def("publish_bytes", [](PyPublisher &self, const std::string &topic, const py::buffer &data)
+             { return publish_buffer(self, topic, data, zmq_simple::ContentType::Raw); }, py::arg("topic"), py::arg("data"), "Publish binary data to a topic without copying")
+        .def("set_compression", [](PyPublisher &self, size_t min_size, size_t dictionary_min_size, const py::bytes &dictionary)
              {
-                 std::string str_data = data;
-                 return self.publish(topic, str_data.c_str(), str_data.size()); }, py::arg("topic"), py::arg("data"), "Publish binary data to a topic");
+                 zmq_simple::CompressionOptions options;
+                 options.min_size = min_size;
+                 options.dictionary_min_size = dictionary_min_size;
+                 std::string dict = dictionary;
+                 options.dictionary.assign(dict.begin(), dict.end());
+                 without_gil(self, [&]
+                             { self.set_compression(options); }); }, py::arg("min_size") = 1024, py::arg("dictionary_min_size") = 64, py::arg("dictionary") = py::bytes(), "Enable LZ4 compression for payloads above the threshold")
+        .def("disable_compression", [](PyPublisher &self)
+             { without_gil(self, [&]
+                           { self.disable_compression(); }); }, "Disable payload compression")
+        .def("publish_json", [](PyPublisher &self, const std::string &topic, const py::object &obj, zmq_simple::ContentType content_type)
+             {
+                 const nlohmann::json doc = to_json(obj);
+                 return without_gil(self, [&]
+                                    {
+                     std::vector<uint8_t> buffer;
+                     return zmq_simple::publish_json(self, topic, doc, content_type, buffer); }); }, py::arg("topic"), py::arg("obj"), py::arg("content_type") = zmq_simple::ContentType::Cbor, "Encode a JSON-compatible object and publish it with a content-type marker");
 
     // Subscriber
-    py::class_<zmq_simple::Subscriber>(m, "Subscriber")
+    py::class_<PySubscriber, std::unique_ptr<PySubscriber, ReleaseGilDelete<PySubscriber>>>(m, "Subscriber")
         .def(py::init<const std::string &, zmq_simple::Transport>(),
              py::arg("endpoint"),
              py::arg("transport") = zmq_simple::Transport::IPC)
@@ -47,28 +555,114 @@ PYBIND11_MODULE(zmq_simple, m)
              py::arg("endpoint"),
              py::arg("transport"),
              py::arg("shared_context"))
-        .def("subscribe",
-             &zmq_simple::Subscriber::subscribe,
-             py::arg("topic") = "",
-             "Subscribe to a topic (empty string subscribes to all topics)")
-        .def("unsubscribe",
-             &zmq_simple::Subscriber::unsubscribe,
-             py::arg("topic"),
-             "Unsubscribe from a topic")
-        .def("receive", [](zmq_simple::Subscriber &self, int timeout_ms)
-             {
-                 std::string topic;
-                 std::vector<uint8_t> data;
-                 bool success = self.receive(topic, data, timeout_ms);
+        .def("subscribe", [](PySubscriber &self, const std::string &topic)
+             { return without_gil(self, [&]
+                                  { return self.subscribe(topic); }); }, py::arg("topic") = "", "Subscribe to a topic (empty string subscribes to all topics)")
+        .def("unsubscribe", [](PySubscriber &self, const std::string &topic)
+             { return without_gil(self, [&]
+                                  { return self.unsubscribe(topic); }); }, py::arg("topic"), "Unsubscribe from a topic")
+        .def("set_compression_dictionary", [](PySubscriber &self, const py::bytes &dictionary)
+             {
+                 std::string dict = dictionary;
+                 without_gil(self, [&]
+                             { self.set_compression_dictionary(std::vector<uint8_t>(dict.begin(), dict.end())); }); }, py::arg("dictionary"), "Set the dictionary used to decompress payloads")
+        .def("add_filter", [](PySubscriber &self, const std::string &expression)
+             { return without_gil(self, [&]
+                                  { return self.add_filter(expression); }); }, py::arg("expression"), "Drop JSON messages unless the condition holds, e.g. '/temperature > 30' (returns False if invalid)")
+        .def("clear_filters", [](PySubscriber &self)
+             { without_gil(self, [&]
+                           { self.clear_filters(); }); }, "Remove all content filters")
+        .def("receive", [](PySubscriber &self, int timeout_ms)
+             {
+                 zmq_simple::Message message;
+                 bool success = without_gil(self, [&]
+                                            { return self.receive(message, timeout_ms); });
                  if (success) {
-                     return py::make_tuple(topic, py::bytes(reinterpret_cast<const char*>(data.data()), data.size()));
+                     return py::make_tuple(message.topic(), message_bytes(message));
                  } else {
                      return py::make_tuple(py::str(), py::bytes());
                  } }, py::arg("timeout_ms") = -1, "Receive a message (returns tuple of (topic, data) or (None, None) on timeout)")
-        .def("start_loop", [](zmq_simple::Subscriber &self, py::function callback)
-             { return self.start_loop([callback](const std::string &topic, const std::vector<uint8_t> &data)
-                                      {
+        .def("receive_message", [](PySubscriber &self, int timeout_ms) -> py::object
+             {
+                 zmq_simple::Message message;
+                 if (!without_gil(self, [&]
+                                  { return self.receive(message, timeout_ms); })) {
+                     return py::none();
+                 }
+                 return py::cast(std::move(message)); }, py::arg("timeout_ms") = -1, "Receive a Message whose payload is exposed without copying (None on timeout)")
+        .def("fileno", [](PySubscriber &self)
+             { return without_gil(self, [&]
+                                  { return self.fd(); }); }, "Edge-triggered ZMQ_FD for event loops; drain with receive_message(0) until readable() is False")
+        .def("readable", [](PySubscriber &self)
+             { return without_gil(self, [&]
+                                  { return self.readable(); }); }, "True if ZMQ_EVENTS reports a pending message")
+        .def("start_loop", [](PySubscriber &self, py::function callback)
+             {
+                 std::shared_ptr<py::function> held = hold_callback(std::move(callback));
+                 return without_gil(self, [&]
+                                    { return self.start_message_loop([held](const zmq_simple::Message &message)
+                                                                     {
+                     py::gil_scoped_acquire acquire;
+                     (*held)(message.topic(), message_bytes(message)); }); }); }, py::arg("callback"), "Start asynchronous message loop with callback")
+        .def("start_message_loop", [](PySubscriber &self, py::function callback)
+             {
+                 std::shared_ptr<py::function> held = hold_callback(std::move(callback));
+                 return without_gil(self, [&]
+                                    { return self.start_message_loop([held](const zmq_simple::Message &message)
+                                                                     {
                      py::gil_scoped_acquire acquire;
-                     callback(topic, py::bytes(reinterpret_cast<const char*>(data.data()), data.size())); }); }, py::arg("callback"), "Start asynchronous message loop with callback")
-        .def("stop_loop", &zmq_simple::Subscriber::stop_loop, "Stop the message loop");
+                     (*held)(message); }); }); }, py::arg("callback"), "Start asynchronous loop delivering Message objects without copying the payload")
+        .def("start_batch_loop", [](PySubscriber &self, py::function callback, size_t max_batch, int max_delay_ms)
+             {
+                 std::shared_ptr<py::function> held = hold_callback(std::move(callback));
+                 zmq_simple::BatchOptions options;
+                 options.max_batch = max_batch;
+                 options.max_delay_ms = max_delay_ms;
+                 return without_gil(self, [&]
+                                    { return self.start_batch_loop([held](std::vector<zmq_simple::Message> &batch)
+                                                                   {
+                     // 每批只获取一次 GIL
+                     py::gil_scoped_acquire acquire;
+                     py::list items(batch.size());
+                     for (size_t i = 0; i < batch.size(); ++i) {
+                         items[i] = py::make_tuple(batch[i].topic(), message_bytes(batch[i]));
+                     }
+                     (*held)(items); }, options); }); }, py::arg("callback"), py::arg("max_batch") = 256, py::arg("max_delay_ms") = 5, "Start asynchronous loop delivering lists of (topic, data) tuples, at most max_batch per call")
+        .def("receive_array", [](PySubscriber &self, int timeout_ms)
+             {
+                 zmq_simple::Message message;
+                 zmq_simple::ArrayInfo info;
+                 const bool success = without_gil(self, [&]
+                                                  { return self.receive(message, timeout_ms) && zmq_simple::decode_array(message, info); });
+                 if (success) {
+                     return py::make_tuple(message.topic(), message_array(message));
+                 }
+                 return py::make_tuple(py::str(), py::none()); }, py::arg("timeout_ms") = -1, "Receive an ARRAY message as a read-only numpy array backed by the message (returns ('', None) on timeout)")
+        .def("receive_json", [](PySubscriber &self, int timeout_ms)
+             {
+                 zmq_simple::Message message;
+                 nlohmann::json doc;
+                 const bool success = without_gil(self, [&]
+                                                  { return self.receive(message, timeout_ms) && zmq_simple::decode_json(message, doc); });
+                 if (success) {
+                     return py::make_tuple(message.topic(), from_json(doc));
+                 }
+                 return py::make_tuple(py::str(), py::none()); }, py::arg("timeout_ms") = -1, "Receive and decode a JSON/CBOR/MsgPack/BJData message (returns (topic, obj) or ('', None) on timeout)")
+        .def("start_json_loop", [](PySubscriber &self, py::function callback)
+             {
+                 std::shared_ptr<py::function> held = hold_callback(std::move(callback));
+                 return without_gil(self, [&]
+                                    { return self.start_message_loop([held](const zmq_simple::Message &message)
+                                                                     {
+                     nlohmann::json doc;
+                     if (!zmq_simple::decode_json(message, doc)) {
+                         return;
+                     }
+                     py::gil_scoped_acquire acquire;
+                     (*held)(message.topic(), from_json(doc)); }); }); }, py::arg("callback"), "Start asynchronous loop delivering decoded JSON objects")
+        .def("stop_loop", [](PySubscriber &self)
+             {
+                 // join 接收线程，线程中的回调可能正在等待 GIL
+                 py::gil_scoped_release release;
+                 self.stop_loop(); }, "Stop the message loop");
 }
@@ -0,0 +1,496 @@
+#include "binary_scan.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace zmq_simple
+{
+    namespace binary_scan
+    {
+        namespace
+        {
+            const int kMaxDepth = 512;
+            const int kMaxTags = 16;
+
+            enum class Type
+            {
+                Number,
+                Text,
+                Bytes, // 字节串、扩展类型、undefined 等 JSON 中没有的值
+                Array,
+                Map,
+                True,
+                False,
+                Null,
+                Break, // CBOR 不定长容器的结束标记
+            };
+
+            // 读取一个值的头部。字符串内容随头部一起跳过，容器只读取元素个数
+            struct Item
+            {
+                Type type;
+                uint64_t count; // Text/Bytes 为字节数，Array 为元素数，Map 为键值对数
+                bool indefinite;
+                double number;
+                const uint8_t *data;
+            };
+
+            uint64_t read_be(const uint8_t *p, size_t n)
+            {
+                uint64_t v = 0;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    v = (v << 8) | p[i];
+                }
+                return v;
+            }
+
+            bool take(const uint8_t *&p, const uint8_t *end, uint64_t size, const uint8_t *&data)
+            {
+                if (static_cast<uint64_t>(end - p) < size)
+                {
+                    return false;
+                }
+                data = p;
+                p += size;
+                return true;
+            }
+
+            double half_to_double(uint16_t h)
+            {
+                const int exponent = (h >> 10) & 0x1f;
+                const int mantissa = h & 0x3ff;
+                double v;
+                if (exponent == 0)
+                {
+                    v = std::ldexp(mantissa, -24);
+                }
+                else if (exponent != 31)
+                {
+                    v = std::ldexp(mantissa + 1024, exponent - 25);
+                }
+                else
+                {
+                    v = mantissa == 0 ? INFINITY : NAN;
+                }
+                return (h & 0x8000) != 0 ? -v : v;
+            }
+
+            double float_bits(uint64_t bits, size_t size)
+            {
+                if (size == 4)
+                {
+                    const uint32_t b = static_cast<uint32_t>(bits);
+                    float f;
+                    std::memcpy(&f, &b, sizeof(f));
+                    return f;
+                }
+                double d;
+                std::memcpy(&d, &bits, sizeof(d));
+                return d;
+            }
+
+            bool read_cbor(const uint8_t *&p, const uint8_t *end, Item &item)
+            {
+                for (int tags = 0; tags <= kMaxTags; ++tags)
+                {
+                    if (p >= end)
+                    {
+                        return false;
+                    }
+                    const uint8_t major = *p >> 5;
+                    const uint8_t info = *p & 0x1f;
+                    ++p;
+                    item.indefinite = false;
+                    uint64_t arg = info;
+                    if (info >= 24 && info <= 27)
+                    {
+                        const size_t n = size_t(1) << (info - 24);
+                        if (static_cast<size_t>(end - p) < n)
+                        {
+                            return false;
+                        }
+                        arg = read_be(p, n);
+                        p += n;
+                    }
+                    else if (info == 31)
+                    {
+                        if (major == 7)
+                        {
+                            item.type = Type::Break;
+                            return true;
+                        }
+                        if (major < 2 || major > 5)
+                        {
+                            return false;
+                        }
+                        item.indefinite = true;
+                    }
+                    else if (info >= 24)
+                    {
+                        return false;
+                    }
+
+                    item.count = arg;
+                    switch (major)
+                    {
+                    case 0:
+                        item.type = Type::Number;
+                        item.number = static_cast<double>(arg);
+                        return true;
+                    case 1:
+                        item.type = Type::Number;
+                        item.number = -1.0 - static_cast<double>(arg);
+                        return true;
+                    case 2:
+                    case 3:
+                        item.type = major == 3 ? Type::Text : Type::Bytes;
+                        if (item.indefinite)
+                        {
+                            // 分段字符串不能直接引用，只跳过，按字节串处理
+                            item.type = Type::Bytes;
+                            Item chunk;
+                            chunk.type = Type::Null;
+                            while (read_cbor(p, end, chunk) && chunk.type != Type::Break)
+                            {
+                                if ((chunk.type != Type::Text && chunk.type != Type::Bytes) || chunk.indefinite)
+                                {
+                                    return false;
+                                }
+                            }
+                            return chunk.type == Type::Break;
+                        }
+                        return take(p, end, arg, item.data);
+                    case 4:
+                        item.type = Type::Array;
+                        return true;
+                    case 5:
+                        item.type = Type::Map;
+                        return true;
+                    case 6:
+                        continue; // 标签只修饰后面的值
+                    default:
+                        break;
+                    }
+
+                    switch (info)
+                    {
+                    case 20: item.type = Type::False; return true;
+                    case 21: item.type = Type::True; return true;
+                    case 22: item.type = Type::Null; return true;
+                    case 25:
+                        item.type = Type::Number;
+                        item.number = half_to_double(static_cast<uint16_t>(arg));
+                        return true;
+                    case 26:
+                    case 27:
+                        item.type = Type::Number;
+                        item.number = float_bits(arg, info == 26 ? 4 : 8);
+                        return true;
+                    default:
+                        item.type = Type::Bytes;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            bool read_msgpack(const uint8_t *&p, const uint8_t *end, Item &item)
+            {
+                if (p >= end)
+                {
+                    return false;
+                }
+                const uint8_t b = *p++;
+                item.indefinite = false;
+                item.count = 0;
+
+                auto fixed = [&](size_t n, uint64_t &v) {
+                    if (static_cast<size_t>(end - p) < n)
+                    {
+                        return false;
+                    }
+                    v = read_be(p, n);
+                    p += n;
+                    return true;
+                };
+                auto sized = [&](Type type, size_t length_bytes, size_t skip) {
+                    uint64_t length = 0;
+                    if (!fixed(length_bytes, length) || static_cast<size_t>(end - p) < skip)
+                    {
+                        return false;
+                    }
+                    p += skip; // 扩展类型的 type 字节
+                    item.type = type;
+                    item.count = length;
+                    return take(p, end, length, item.data);
+                };
+                auto container = [&](Type type, size_t length_bytes) {
+                    item.type = type;
+                    return fixed(length_bytes, item.count);
+                };
+
+                if (b <= 0x7f || b >= 0xe0)
+                {
+                    item.type = Type::Number;
+                    item.number = static_cast<int8_t>(b);
+                    return true;
+                }
+                if (b <= 0x8f)
+                {
+                    item.type = Type::Map;
+                    item.count = b & 0x0f;
+                    return true;
+                }
+                if (b <= 0x9f)
+                {
+                    item.type = Type::Array;
+                    item.count = b & 0x0f;
+                    return true;
+                }
+                if (b <= 0xbf)
+                {
+                    item.type = Type::Text;
+                    item.count = b & 0x1f;
+                    return take(p, end, item.count, item.data);
+                }
+
+                uint64_t v = 0;
+                switch (b)
+                {
+                case 0xc0: item.type = Type::Null; return true;
+                case 0xc2: item.type = Type::False; return true;
+                case 0xc3: item.type = Type::True; return true;
+                case 0xc4: return sized(Type::Bytes, 1, 0);
+                case 0xc5: return sized(Type::Bytes, 2, 0);
+                case 0xc6: return sized(Type::Bytes, 4, 0);
+                case 0xc7: return sized(Type::Bytes, 1, 1);
+                case 0xc8: return sized(Type::Bytes, 2, 1);
+                case 0xc9: return sized(Type::Bytes, 4, 1);
+                case 0xca:
+                case 0xcb:
+                    if (!fixed(b == 0xca ? 4 : 8, v))
+                    {
+                        return false;
+                    }
+                    item.type = Type::Number;
+                    item.number = float_bits(v, b == 0xca ? 4 : 8);
+                    return true;
+                case 0xcc:
+                case 0xcd:
+                case 0xce:
+                case 0xcf:
+                    if (!fixed(size_t(1) << (b - 0xcc), v))
+                    {
+                        return false;
+                    }
+                    item.type = Type::Number;
+                    item.number = static_cast<double>(v);
+                    return true;
+                case 0xd0:
+                case 0xd1:
+                case 0xd2:
+                case 0xd3:
+                {
+                    const size_t n = size_t(1) << (b - 0xd0);
+                    if (!fixed(n, v))
+                    {
+                        return false;
+                    }
+                    // 符号扩展
+                    const unsigned shift = static_cast<unsigned>(64 - 8 * n);
+                    int64_t s;
+                    v <<= shift;
+                    std::memcpy(&s, &v, sizeof(s));
+                    item.type = Type::Number;
+                    item.number = static_cast<double>(s >> shift);
+                    return true;
+                }
+                case 0xd4:
+                case 0xd5:
+                case 0xd6:
+                case 0xd7:
+                case 0xd8:
+                {
+                    const uint64_t n = uint64_t(1) << (b - 0xd4);
+                    item.type = Type::Bytes;
+                    return take(p, end, n + 1, item.data);
+                }
+                case 0xd9: return sized(Type::Text, 1, 0);
+                case 0xda: return sized(Type::Text, 2, 0);
+                case 0xdb: return sized(Type::Text, 4, 0);
+                case 0xdc: return container(Type::Array, 2);
+                case 0xdd: return container(Type::Array, 4);
+                case 0xde: return container(Type::Map, 2);
+                case 0xdf: return container(Type::Map, 4);
+                default:
+                    return false; // 0xc1 未使用
+                }
+            }
+
+            class Reader
+            {
+            public:
+                Reader(Format format, const uint8_t *begin, const uint8_t *end) : format_(format), p_(begin), end_(end) {}
+
+                bool read(Item &item)
+                {
+                    return format_ == Format::Cbor ? read_cbor(p_, end_, item) : read_msgpack(p_, end_, item);
+                }
+
+                // 头部已读取，跳过容器的全部元素
+                bool skip(const Item &item, int depth = 0)
+                {
+                    if (item.type != Type::Array && item.type != Type::Map)
+                    {
+                        return true;
+                    }
+                    if (depth >= kMaxDepth)
+                    {
+                        return false;
+                    }
+                    const uint64_t per_entry = item.type == Type::Map ? 2 : 1;
+                    Item child;
+                    for (uint64_t i = 0; item.indefinite || i < item.count; ++i)
+                    {
+                        for (uint64_t k = 0; k < per_entry; ++k)
+                        {
+                            if (!read(child))
+                            {
+                                return false;
+                            }
+                            if (child.type == Type::Break)
+                            {
+                                return item.indefinite && k == 0;
+                            }
+                            if (!skip(child, depth + 1))
+                            {
+                                return false;
+                            }
+                        }
+                    }
+                    return true;
+                }
+
+                // 在对象中查找键，找到时 item 为对应的值
+                bool member(Item &item, const std::string &key)
+                {
+                    Item name;
+                    for (uint64_t i = 0; item.indefinite || i < item.count; ++i)
+                    {
+                        if (!read(name) || name.type == Type::Break)
+                        {
+                            return false;
+                        }
+                        const bool match = name.type == Type::Text && name.count == key.size() &&
+                                           std::memcmp(name.data, key.data(), key.size()) == 0;
+                        if (!skip(name))
+                        {
+                            return false;
+                        }
+                        Item value;
+                        if (!read(value) || value.type == Type::Break)
+                        {
+                            return false;
+                        }
+                        if (match)
+                        {
+                            item = value;
+                            return true;
+                        }
+                        if (!skip(value))
+                        {
+                            return false;
+                        }
+                    }
+                    return false;
+                }
+
+                bool element(Item &item, uint64_t index)
+                {
+                    if (!item.indefinite && index >= item.count)
+                    {
+                        return false;
+                    }
+                    Item value;
+                    for (uint64_t i = 0;; ++i)
+                    {
+                        if (!read(value) || value.type == Type::Break)
+                        {
+                            return false;
+                        }
+                        if (i == index)
+                        {
+                            item = value;
+                            return true;
+                        }
+                        if (!skip(value))
+                        {
+                            return false;
+                        }
+                    }
+                }
+
+            private:
+                Format format_;
+                const uint8_t *p_;
+                const uint8_t *end_;
+            };
+        } // namespace
+
+        bool find(Format format, const uint8_t *begin, const uint8_t *end, const std::vector<std::string> &tokens,
+                  Value &value)
+        {
+            Reader reader(format, begin, end);
+            Item item;
+            if (!reader.read(item))
+            {
+                return false;
+            }
+            for (const std::string &token : tokens)
+            {
+                size_t index = 0;
+                if (item.type == Type::Map)
+                {
+                    if (!reader.member(item, token))
+                    {
+                        return false;
+                    }
+                }
+                else if (item.type == Type::Array && json_scan::parse_index(token, index))
+                {
+                    if (!reader.element(item, index))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            value.number = 0;
+            value.begin = value.end = nullptr;
+            switch (item.type)
+            {
+            case Type::Number:
+                value.kind = json_scan::Kind::Number;
+                value.number = item.number;
+                return true;
+            case Type::Text:
+                value.kind = json_scan::Kind::String;
+                value.begin = reinterpret_cast<const char *>(item.data);
+                value.end = value.begin + item.count;
+                return true;
+            case Type::True: value.kind = json_scan::Kind::True; return true;
+            case Type::False: value.kind = json_scan::Kind::False; return true;
+            case Type::Null: value.kind = json_scan::Kind::Null; return true;
+            case Type::Array: value.kind = json_scan::Kind::Array; return true;
+            case Type::Map: value.kind = json_scan::Kind::Object; return true;
+            default:
+                return false; // 字节串等 JSON 中没有的值视为不存在
+            }
+        }
+    } // namespace binary_scan
+
+} // namespace zmq_simple
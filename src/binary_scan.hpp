@@ -0,0 +1,33 @@
+#ifndef ZMQ_SIMPLE_BINARY_SCAN_HPP
+#define ZMQ_SIMPLE_BINARY_SCAN_HPP
+
+#include "json_scan.hpp"
+
+namespace zmq_simple
+{
+    // 直接在 CBOR / MessagePack 字节上按 JSON Pointer 定位标量，不解码整个文档、不分配内存。
+    // 与 json_scan 相同，只做定位所需的校验
+    namespace binary_scan
+    {
+        enum class Format
+        {
+            Cbor,
+            MsgPack,
+        };
+
+        struct Value
+        {
+            json_scan::Kind kind;
+            double number;     // Kind::Number
+            const char *begin; // Kind::String: UTF-8 字节，没有转义
+            const char *end;
+        };
+
+        // 对象的键只匹配文本字符串，数组按十进制下标查找；找不到或遇到非法内容返回 false
+        bool find(Format format, const uint8_t *begin, const uint8_t *end, const std::vector<std::string> &tokens,
+                  Value &value);
+    } // namespace binary_scan
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_BINARY_SCAN_HPP
@@ -0,0 +1,184 @@
+#include "../include/zmq_simple.hpp"
+#include <atomic>
+#include <mutex>
+#include <new>
+
+namespace zmq_simple
+{
+    namespace
+    {
+        const size_t kMinClassShift = 6;  // 64B
+        const size_t kClassCount = 17;    // 64B ~ 4MB
+        const size_t kNoClass = static_cast<size_t>(-1);
+
+        inline size_t class_size(size_t index)
+        {
+            return size_t(1) << (index + kMinClassShift);
+        }
+
+        size_t class_for(size_t size)
+        {
+            size_t index = 0;
+            while (index < kClassCount && class_size(index) < size)
+            {
+                ++index;
+            }
+            return index < kClassCount ? index : kNoClass;
+        }
+    } // namespace
+
+    class BufferPool::Impl
+    {
+    public:
+        explicit Impl(size_t max_cached_bytes)
+            : max_cached_bytes_(max_cached_bytes), allocations_(0), hits_(0), misses_(0), oversize_(0),
+              cached_bytes_(0), in_use_bytes_(0), requested_bytes_(0)
+        {
+        }
+
+        ~Impl()
+        {
+            trim();
+        }
+
+        void *allocate(size_t size)
+        {
+            ++allocations_;
+            const size_t index = class_for(size);
+            if (index == kNoClass)
+            {
+                ++oversize_;
+                void *p = ::operator new(size);
+                in_use_bytes_ += size;
+                requested_bytes_ += size;
+                return p;
+            }
+
+            const size_t block = class_size(index);
+            void *p = nullptr;
+            {
+                SizeClass &sc = classes_[index];
+                std::lock_guard<std::mutex> lock(sc.mutex);
+                if (!sc.free.empty())
+                {
+                    p = sc.free.back();
+                    sc.free.pop_back();
+                }
+            }
+            if (p != nullptr)
+            {
+                ++hits_;
+                cached_bytes_ -= block;
+            }
+            else
+            {
+                ++misses_;
+                p = ::operator new(block);
+            }
+            in_use_bytes_ += block;
+            requested_bytes_ += size;
+            return p;
+        }
+
+        void deallocate(void *p, size_t size)
+        {
+            if (p == nullptr)
+            {
+                return;
+            }
+            const size_t index = class_for(size);
+            const size_t block = index == kNoClass ? size : class_size(index);
+            in_use_bytes_ -= block;
+            requested_bytes_ -= size;
+
+            // 超过缓存上限时直接释放
+            if (index == kNoClass || cached_bytes_.fetch_add(block) + block > max_cached_bytes_)
+            {
+                if (index != kNoClass)
+                {
+                    cached_bytes_ -= block;
+                }
+                ::operator delete(p);
+                return;
+            }
+            SizeClass &sc = classes_[index];
+            std::lock_guard<std::mutex> lock(sc.mutex);
+            sc.free.push_back(p);
+        }
+
+        BufferPoolStats stats() const
+        {
+            BufferPoolStats s;
+            s.allocations = allocations_;
+            s.hits = hits_;
+            s.misses = misses_;
+            s.oversize = oversize_;
+            s.cached_bytes = cached_bytes_;
+            s.in_use_bytes = in_use_bytes_;
+            s.requested_bytes = requested_bytes_;
+            return s;
+        }
+
+        void trim()
+        {
+            for (size_t i = 0; i < kClassCount; ++i)
+            {
+                std::vector<void *> blocks;
+                {
+                    std::lock_guard<std::mutex> lock(classes_[i].mutex);
+                    blocks.swap(classes_[i].free);
+                }
+                for (void *p : blocks)
+                {
+                    ::operator delete(p);
+                }
+                cached_bytes_ -= blocks.size() * class_size(i);
+            }
+        }
+
+    private:
+        struct SizeClass
+        {
+            std::mutex mutex;
+            std::vector<void *> free;
+        };
+
+        size_t max_cached_bytes_;
+        SizeClass classes_[kClassCount];
+        std::atomic<uint64_t> allocations_;
+        std::atomic<uint64_t> hits_;
+        std::atomic<uint64_t> misses_;
+        std::atomic<uint64_t> oversize_;
+        std::atomic<size_t> cached_bytes_;
+        std::atomic<size_t> in_use_bytes_;
+        std::atomic<size_t> requested_bytes_;
+    };
+
+    BufferPool::BufferPool(size_t max_cached_bytes)
+        : pimpl_(std::make_unique<Impl>(max_cached_bytes))
+    {
+    }
+
+    BufferPool::~BufferPool() = default;
+
+    void *BufferPool::allocate(size_t size)
+    {
+        return pimpl_->allocate(size);
+    }
+
+    void BufferPool::deallocate(void *p, size_t size)
+    {
+        pimpl_->deallocate(p, size);
+    }
+
+    BufferPoolStats BufferPool::stats() const
+    {
+        return pimpl_->stats();
+    }
+
+    void BufferPool::trim()
+    {
+        pimpl_->trim();
+    }
+
+} // namespace zmq_simple
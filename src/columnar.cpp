@@ -0,0 +1,450 @@
+#include "../include/zmq_simple_columnar.hpp"
+#include "lz4_block.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace zmq_simple
+{
+    namespace
+    {
+        // 块格式: [BlockHeader][ColumnHeader x columns][列名]，之后每列从 64 字节对齐的偏移开始
+        const uint8_t kBlockVersion = 1;
+        const size_t kColumnAlignment = 64;
+        const uint8_t kColumnCompressed = 1;
+
+#pragma pack(push, 1)
+        struct BlockHeader
+        {
+            uint8_t version;
+            uint8_t reserved[3];
+            uint32_t columns;
+            uint64_t rows;
+        };
+
+        struct ColumnHeader
+        {
+            uint8_t type;
+            uint8_t flags;
+            uint16_t name_size;
+            uint32_t name_offset;
+            uint64_t offset;      // 相对块起始
+            uint64_t stored_size; // 压缩后长度，未压缩时等于 raw_size
+            uint64_t raw_size;
+        };
+#pragma pack(pop)
+
+        size_t value_size(ColumnType type)
+        {
+            switch (type)
+            {
+            case ColumnType::Int64:
+            case ColumnType::Float64:
+                return 8;
+            case ColumnType::Bool:
+                return 1;
+            default:
+                return 0;
+            }
+        }
+
+        size_t alignment_of(ColumnType type)
+        {
+            return type == ColumnType::Bool ? 1 : type == ColumnType::String ? 4 : 8;
+        }
+
+        void pad(std::vector<uint8_t> &buffer)
+        {
+            buffer.resize((buffer.size() + kColumnAlignment - 1) / kColumnAlignment * kColumnAlignment, 0);
+        }
+
+        // 字符串列: 偏移单调不减且不超出字符数据
+        bool valid_strings(const uint8_t *data, size_t size, size_t rows)
+        {
+            const size_t table = (rows + 1) * sizeof(uint32_t);
+            if (size < table)
+            {
+                return false;
+            }
+            uint32_t previous = 0;
+            for (size_t i = 0; i <= rows; ++i)
+            {
+                uint32_t offset;
+                std::memcpy(&offset, data + i * sizeof(uint32_t), sizeof(offset));
+                if (offset < previous || offset > size - table)
+                {
+                    return false;
+                }
+                previous = offset;
+            }
+            return previous == size - table;
+        }
+    } // namespace
+
+    ColumnarPublisher::ColumnarPublisher(Publisher &publisher, const std::string &topic,
+                                         const std::vector<ColumnSpec> &columns, const ColumnarOptions &options)
+        : publisher_(publisher), topic_(topic), options_(options), rows_(0), in_row_(false)
+    {
+        if (columns.empty() || columns.size() > UINT32_MAX)
+        {
+            throw std::runtime_error("Columnar channel requires at least one column");
+        }
+        for (const ColumnSpec &spec : columns)
+        {
+            if (spec.name.size() > UINT16_MAX || (value_size(spec.type) == 0 && spec.type != ColumnType::String))
+            {
+                throw std::runtime_error("Invalid column: " + spec.name);
+            }
+            Column column;
+            column.spec = spec;
+            if (spec.type == ColumnType::String)
+            {
+                column.offsets.push_back(0);
+            }
+            columns_.push_back(std::move(column));
+        }
+        options_.max_rows = std::max<size_t>(1, options_.max_rows);
+    }
+
+    ColumnarPublisher::~ColumnarPublisher()
+    {
+        flush();
+    }
+
+    size_t ColumnarPublisher::column(const std::string &name) const
+    {
+        for (size_t i = 0; i < columns_.size(); ++i)
+        {
+            if (columns_[i].spec.name == name)
+            {
+                return i;
+            }
+        }
+        throw std::runtime_error("Unknown column: " + name);
+    }
+
+    void ColumnarPublisher::begin_row()
+    {
+        if (in_row_)
+        {
+            end_row();
+        }
+        if (rows_ == 0)
+        {
+            first_row_ = std::chrono::steady_clock::now();
+        }
+        for (Column &column : columns_)
+        {
+            if (column.spec.type == ColumnType::String)
+            {
+                column.offsets.push_back(static_cast<uint32_t>(column.chars.size()));
+            }
+            else
+            {
+                column.data.resize(column.data.size() + value_size(column.spec.type), 0);
+            }
+        }
+        ++rows_;
+        in_row_ = true;
+    }
+
+    bool ColumnarPublisher::set(size_t column, int64_t value)
+    {
+        if (!in_row_ || column >= columns_.size())
+        {
+            return false;
+        }
+        Column &target = columns_[column];
+        if (target.spec.type == ColumnType::Float64)
+        {
+            return set(column, static_cast<double>(value));
+        }
+        if (target.spec.type != ColumnType::Int64)
+        {
+            return false;
+        }
+        std::memcpy(target.data.data() + target.data.size() - sizeof(value), &value, sizeof(value));
+        return true;
+    }
+
+    bool ColumnarPublisher::set(size_t column, double value)
+    {
+        if (!in_row_ || column >= columns_.size() || columns_[column].spec.type != ColumnType::Float64)
+        {
+            return false;
+        }
+        std::vector<uint8_t> &data = columns_[column].data;
+        std::memcpy(data.data() + data.size() - sizeof(value), &value, sizeof(value));
+        return true;
+    }
+
+    bool ColumnarPublisher::set(size_t column, bool value)
+    {
+        if (!in_row_ || column >= columns_.size() || columns_[column].spec.type != ColumnType::Bool)
+        {
+            return false;
+        }
+        columns_[column].data.back() = value ? 1 : 0;
+        return true;
+    }
+
+    bool ColumnarPublisher::set(size_t column, const std::string &value)
+    {
+        return set(column, value.data(), value.size());
+    }
+
+    bool ColumnarPublisher::set(size_t column, const char *value, size_t size)
+    {
+        if (!in_row_ || column >= columns_.size() || columns_[column].spec.type != ColumnType::String)
+        {
+            return false;
+        }
+        Column &target = columns_[column];
+        // 当前行总是最后一行，重复设置时覆盖
+        const size_t begin = target.offsets[target.offsets.size() - 2];
+        if (begin + size > UINT32_MAX)
+        {
+            return false;
+        }
+        target.chars.resize(begin);
+        target.chars.append(value, size);
+        target.offsets.back() = static_cast<uint32_t>(target.chars.size());
+        return true;
+    }
+
+    bool ColumnarPublisher::end_row()
+    {
+        if (!in_row_)
+        {
+            return false;
+        }
+        in_row_ = false;
+        if (rows_ >= options_.max_rows ||
+            std::chrono::steady_clock::now() - first_row_ >= std::chrono::milliseconds(options_.max_delay_ms))
+        {
+            return flush();
+        }
+        return true;
+    }
+
+    bool ColumnarPublisher::flush()
+    {
+        in_row_ = false;
+        if (rows_ == 0)
+        {
+            return true;
+        }
+
+        buffer_.clear();
+        BlockHeader block;
+        std::memset(&block, 0, sizeof(block));
+        block.version = kBlockVersion;
+        block.columns = static_cast<uint32_t>(columns_.size());
+        block.rows = rows_;
+        buffer_.resize(sizeof(block) + columns_.size() * sizeof(ColumnHeader));
+        std::memcpy(buffer_.data(), &block, sizeof(block));
+
+        std::vector<ColumnHeader> headers(columns_.size());
+        for (size_t i = 0; i < columns_.size(); ++i)
+        {
+            const std::string &name = columns_[i].spec.name;
+            std::memset(&headers[i], 0, sizeof(ColumnHeader));
+            headers[i].type = static_cast<uint8_t>(columns_[i].spec.type);
+            headers[i].name_size = static_cast<uint16_t>(name.size());
+            headers[i].name_offset = static_cast<uint32_t>(buffer_.size());
+            buffer_.insert(buffer_.end(), name.begin(), name.end());
+        }
+
+        for (size_t i = 0; i < columns_.size(); ++i)
+        {
+            Column &column = columns_[i];
+            pad(buffer_);
+            const size_t offset = buffer_.size();
+            if (column.spec.type == ColumnType::String)
+            {
+                const uint8_t *table = reinterpret_cast<const uint8_t *>(column.offsets.data());
+                buffer_.insert(buffer_.end(), table, table + column.offsets.size() * sizeof(uint32_t));
+                buffer_.insert(buffer_.end(), column.chars.begin(), column.chars.end());
+            }
+            else
+            {
+                buffer_.insert(buffer_.end(), column.data.begin(), column.data.end());
+            }
+
+            const size_t raw_size = buffer_.size() - offset;
+            headers[i].offset = offset;
+            headers[i].raw_size = raw_size;
+            headers[i].stored_size = raw_size;
+            if (options_.compress && raw_size > 0)
+            {
+                scratch_.resize(lz4::compress_bound(raw_size));
+                const size_t compressed = lz4::compress(buffer_.data() + offset, raw_size, scratch_.data(), scratch_.size());
+                // 只保留有收益的列
+                if (compressed != 0 && compressed < raw_size)
+                {
+                    buffer_.resize(offset);
+                    buffer_.insert(buffer_.end(), scratch_.begin(), scratch_.begin() + compressed);
+                    headers[i].flags = kColumnCompressed;
+                    headers[i].stored_size = compressed;
+                }
+            }
+
+            column.data.clear();
+            column.chars.clear();
+            column.offsets.assign(column.spec.type == ColumnType::String ? 1 : 0, 0);
+        }
+        std::memcpy(buffer_.data() + sizeof(block), headers.data(), headers.size() * sizeof(ColumnHeader));
+
+        rows_ = 0;
+        return publisher_.publish(topic_, buffer_.data(), buffer_.size(), ContentType::Columnar);
+    }
+
+    bool ColumnarBlock::parse(const Message &message)
+    {
+        if (message.content_type() != ContentType::Columnar || !parse(message.data(), message.size()))
+        {
+            message_ = Message();
+            return false;
+        }
+        message_ = message;
+        return true;
+    }
+
+    bool ColumnarBlock::parse(const uint8_t *data, size_t size)
+    {
+        message_ = Message();
+        rows_ = 0;
+        columns_.clear();
+
+        BlockHeader block;
+        if (size < sizeof(block))
+        {
+            return false;
+        }
+        std::memcpy(&block, data, sizeof(block));
+        if (block.version != kBlockVersion || block.columns > (size - sizeof(block)) / sizeof(ColumnHeader) ||
+            block.rows > size)
+        {
+            return false;
+        }
+        const size_t rows = static_cast<size_t>(block.rows);
+
+        size_t owned = 0;
+        for (uint32_t i = 0; i < block.columns; ++i)
+        {
+            ColumnHeader header;
+            std::memcpy(&header, data + sizeof(block) + i * sizeof(header), sizeof(header));
+            const ColumnType type = static_cast<ColumnType>(header.type);
+            if ((value_size(type) == 0 && type != ColumnType::String) ||
+                header.name_offset > size || header.name_size > size - header.name_offset ||
+                header.offset > size || header.stored_size > size - header.offset)
+            {
+                return false;
+            }
+            // 定长列的长度由行数决定，压缩列解压前先检查，避免按伪造的长度分配
+            const bool compressed = (header.flags & kColumnCompressed) != 0;
+            const bool size_ok = value_size(type) != 0 ? header.raw_size == rows * value_size(type)
+                                                       : header.raw_size >= (rows + 1) * sizeof(uint32_t);
+            if (!size_ok || (!compressed && header.raw_size != header.stored_size))
+            {
+                return false;
+            }
+            if (compressed && header.raw_size > header.stored_size * 255 + 16)
+            {
+                return false; // 超出 LZ4 的最大压缩比
+            }
+
+            Column column;
+            column.name.assign(reinterpret_cast<const char *>(data) + header.name_offset, header.name_size);
+            column.type = type;
+            column.size = static_cast<size_t>(header.raw_size);
+            column.data = data + header.offset;
+
+            const bool aligned = reinterpret_cast<uintptr_t>(column.data) % alignment_of(type) == 0;
+            if (compressed || !aligned)
+            {
+                if (owned == owned_.size())
+                {
+                    owned_.emplace_back();
+                }
+                std::vector<uint64_t> &buffer = owned_[owned++];
+                buffer.resize((column.size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+                uint8_t *target = reinterpret_cast<uint8_t *>(buffer.data());
+                if (compressed)
+                {
+                    if (!lz4::decompress(column.data, static_cast<size_t>(header.stored_size), target, column.size))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    std::memcpy(target, column.data, column.size);
+                }
+                column.data = target;
+            }
+
+            if (type == ColumnType::String && !valid_strings(column.data, column.size, rows))
+            {
+                return false;
+            }
+            columns_.push_back(std::move(column));
+        }
+        rows_ = rows;
+        return true;
+    }
+
+    size_t ColumnarBlock::find(const std::string &name) const
+    {
+        for (size_t i = 0; i < columns_.size(); ++i)
+        {
+            if (columns_[i].name == name)
+            {
+                return i;
+            }
+        }
+        return kNoColumn;
+    }
+
+    ColumnSpan<int64_t> ColumnarBlock::int64s(size_t column) const
+    {
+        if (column >= columns_.size() || columns_[column].type != ColumnType::Int64)
+        {
+            return ColumnSpan<int64_t>();
+        }
+        return ColumnSpan<int64_t>(reinterpret_cast<const int64_t *>(columns_[column].data), rows_);
+    }
+
+    ColumnSpan<double> ColumnarBlock::float64s(size_t column) const
+    {
+        if (column >= columns_.size() || columns_[column].type != ColumnType::Float64)
+        {
+            return ColumnSpan<double>();
+        }
+        return ColumnSpan<double>(reinterpret_cast<const double *>(columns_[column].data), rows_);
+    }
+
+    ColumnSpan<uint8_t> ColumnarBlock::bools(size_t column) const
+    {
+        if (column >= columns_.size() || columns_[column].type != ColumnType::Bool)
+        {
+            return ColumnSpan<uint8_t>();
+        }
+        return ColumnSpan<uint8_t>(columns_[column].data, rows_);
+    }
+
+    ColumnarBlock::StringRef ColumnarBlock::string(size_t column, size_t row) const
+    {
+        StringRef ref = {nullptr, 0};
+        if (column >= columns_.size() || columns_[column].type != ColumnType::String || row >= rows_)
+        {
+            return ref;
+        }
+        const uint32_t *offsets = reinterpret_cast<const uint32_t *>(columns_[column].data);
+        const char *chars = reinterpret_cast<const char *>(offsets + rows_ + 1);
+        ref.data = chars + offsets[row];
+        ref.size = offsets[row + 1] - offsets[row];
+        return ref;
+    }
+
+} // namespace zmq_simple
@@ -0,0 +1,155 @@
+#include "../include/zmq_simple.hpp"
+#include "compression.hpp"
+#include "lz4_block.hpp"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace zmq_simple
+{
+    namespace
+    {
+        const size_t kDmerSize = 8;     // 统计频率的最小片段长度
+        const size_t kSegmentSize = 64; // 写入字典的片段长度
+
+        inline uint64_t read_dmer(const uint8_t *p)
+        {
+            uint64_t v = 0;
+            for (size_t i = 0; i < kDmerSize; ++i)
+            {
+                v = (v << 8) | p[i];
+            }
+            return v;
+        }
+
+        struct Segment
+        {
+            const std::string *sample;
+            size_t begin;
+            uint64_t score;
+        };
+    } // namespace
+
+    uint32_t dictionary_id(const std::vector<uint8_t> &dictionary)
+    {
+        if (dictionary.empty())
+        {
+            return 0;
+        }
+        // FNV-1a，0 保留表示"无字典"
+        uint32_t h = 2166136261U;
+        for (uint8_t b : dictionary)
+        {
+            h = (h ^ b) * 16777619U;
+        }
+        return h == 0 ? 1 : h;
+    }
+
+    // 简化的 COVER 算法: 统计每个 dmer 出现在多少个样本中，
+    // 选出得分最高且互不重复的片段拼成字典，最有价值的片段放在末尾(离数据最近)
+    std::vector<uint8_t> train_compression_dictionary(const std::vector<std::string> &samples, size_t capacity)
+    {
+        capacity = std::min(capacity, lz4::kMaxDictionarySize);
+
+        std::unordered_map<uint64_t, uint32_t> frequency;
+        for (const std::string &sample : samples)
+        {
+            if (sample.size() < kDmerSize)
+            {
+                continue;
+            }
+            std::unordered_set<uint64_t> seen;
+            const uint8_t *p = reinterpret_cast<const uint8_t *>(sample.data());
+            for (size_t i = 0; i + kDmerSize <= sample.size(); ++i)
+            {
+                if (seen.insert(read_dmer(p + i)).second)
+                {
+                    ++frequency[read_dmer(p + i)];
+                }
+            }
+        }
+
+        std::vector<Segment> candidates;
+        for (const std::string &sample : samples)
+        {
+            const uint8_t *p = reinterpret_cast<const uint8_t *>(sample.data());
+            const size_t step = kSegmentSize / 4;
+            for (size_t begin = 0; begin + kDmerSize <= sample.size(); begin += step)
+            {
+                const size_t end = std::min(sample.size(), begin + kSegmentSize);
+                uint64_t score = 0;
+                for (size_t i = begin; i + kDmerSize <= end; ++i)
+                {
+                    const uint32_t f = frequency[read_dmer(p + i)];
+                    score += f > 1 ? f : 0;
+                }
+                if (score > 0)
+                {
+                    candidates.push_back(Segment{&sample, begin, score});
+                }
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Segment &a, const Segment &b)
+                  { return a.score > b.score; });
+
+        std::vector<std::string> chosen;
+        std::unordered_set<uint64_t> covered;
+        size_t total = 0;
+        for (const Segment &segment : candidates)
+        {
+            if (total >= capacity)
+            {
+                break;
+            }
+
+            const std::string &sample = *segment.sample;
+            const uint8_t *p = reinterpret_cast<const uint8_t *>(sample.data());
+            const size_t end = std::min(sample.size(), segment.begin + kSegmentSize);
+
+            // 已被其他片段覆盖过半的候选直接跳过
+            uint64_t fresh = 0;
+            for (size_t i = segment.begin; i + kDmerSize <= end; ++i)
+            {
+                const uint64_t dmer = read_dmer(p + i);
+                if (covered.count(dmer) == 0)
+                {
+                    const uint32_t f = frequency[dmer];
+                    fresh += f > 1 ? f : 0;
+                }
+            }
+            if (fresh * 2 < segment.score)
+            {
+                continue;
+            }
+
+            for (size_t i = segment.begin; i + kDmerSize <= end; ++i)
+            {
+                covered.insert(read_dmer(p + i));
+            }
+            const size_t len = std::min(end - segment.begin, capacity - total);
+            chosen.push_back(sample.substr(segment.begin, len));
+            total += len;
+        }
+
+        std::vector<uint8_t> dictionary;
+        dictionary.reserve(total);
+        for (auto it = chosen.rbegin(); it != chosen.rend(); ++it)
+        {
+            dictionary.insert(dictionary.end(), it->begin(), it->end());
+        }
+
+        // 样本之间没有重复内容时，退化为直接拼接最近的样本
+        if (dictionary.empty())
+        {
+            for (auto it = samples.rbegin(); it != samples.rend() && dictionary.size() < capacity; ++it)
+            {
+                const size_t len = std::min(it->size(), capacity - dictionary.size());
+                dictionary.insert(dictionary.begin(), it->end() - len, it->end());
+            }
+        }
+        return dictionary;
+    }
+
+} // namespace zmq_simple
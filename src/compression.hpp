@@ -0,0 +1,14 @@
+#ifndef ZMQ_SIMPLE_COMPRESSION_HPP
+#define ZMQ_SIMPLE_COMPRESSION_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace zmq_simple
+{
+    // 字典内容的哈希，随 envelope 发送，订阅端据此确认双方字典一致
+    uint32_t dictionary_id(const std::vector<uint8_t> &dictionary);
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_COMPRESSION_HPP
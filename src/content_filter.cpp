@@ -0,0 +1,198 @@
+#include "content_filter.hpp"
+#include "binary_scan.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace zmq_simple
+{
+    namespace
+    {
+        bool is_space(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        bool is_operator(char c)
+        {
+            return c == '=' || c == '!' || c == '<' || c == '>';
+        }
+    } // namespace
+
+    bool ContentFilter::parse(const std::string &expression, ContentFilter &filter)
+    {
+        const char *p = expression.data();
+        const char *end = p + expression.size();
+        while (p < end && is_space(*p))
+        {
+            ++p;
+        }
+
+        const char *pointer = p;
+        while (p < end && !is_space(*p) && !is_operator(*p))
+        {
+            ++p;
+        }
+        ContentFilter result;
+        if (p == pointer || !json_scan::split_pointer(std::string(pointer, p), result.tokens_))
+        {
+            return false;
+        }
+
+        while (p < end && is_space(*p))
+        {
+            ++p;
+        }
+        if (p == end)
+        {
+            result.op_ = Op::Exists;
+            filter = std::move(result);
+            return true;
+        }
+
+        const std::string op(p, std::min<size_t>(2, static_cast<size_t>(end - p)));
+        if (op == "==" || op == "!=" || op == "<=" || op == ">=")
+        {
+            result.op_ = op == "==" ? Op::Eq : op == "!=" ? Op::Ne : op == "<=" ? Op::Le : Op::Ge;
+            p += 2;
+        }
+        else if (*p == '<' || *p == '>')
+        {
+            result.op_ = *p == '<' ? Op::Lt : Op::Gt;
+            ++p;
+        }
+        else
+        {
+            return false;
+        }
+
+        json_scan::Value literal;
+        const char *next = nullptr;
+        if (!json_scan::read_value(p, end, literal, next))
+        {
+            return false;
+        }
+        while (next < end && is_space(*next))
+        {
+            ++next;
+        }
+        if (next != end)
+        {
+            return false;
+        }
+
+        result.kind_ = literal.kind;
+        switch (literal.kind)
+        {
+        case json_scan::Kind::Number:
+            if (!json_scan::to_number(literal, result.number_))
+            {
+                return false;
+            }
+            break;
+        case json_scan::Kind::String:
+            if (!json_scan::unescape(literal.begin, literal.end, result.text_))
+            {
+                return false;
+            }
+            break;
+        case json_scan::Kind::True:
+        case json_scan::Kind::False:
+        case json_scan::Kind::Null:
+            if (result.op_ != Op::Eq && result.op_ != Op::Ne)
+            {
+                return false;
+            }
+            break;
+        default:
+            return false; // 不支持与对象、数组比较
+        }
+
+        filter = std::move(result);
+        return true;
+    }
+
+    template <typename T>
+    bool ContentFilter::compare(const T &lhs, const T &rhs) const
+    {
+        switch (op_)
+        {
+        case Op::Eq: return lhs == rhs;
+        case Op::Ne: return !(lhs == rhs);
+        case Op::Lt: return lhs < rhs;
+        case Op::Le: return !(rhs < lhs);
+        case Op::Gt: return rhs < lhs;
+        case Op::Ge: return !(lhs < rhs);
+        default: return true;
+        }
+    }
+
+    bool ContentFilter::supports(ContentType content_type)
+    {
+        return content_type == ContentType::Raw || content_type == ContentType::Json ||
+               content_type == ContentType::Cbor || content_type == ContentType::MsgPack;
+    }
+
+    bool ContentFilter::matches(ContentType content_type, const uint8_t *data, size_t size) const
+    {
+        if (content_type == ContentType::Cbor || content_type == ContentType::MsgPack)
+        {
+            binary_scan::Value value;
+            const binary_scan::Format format =
+                content_type == ContentType::Cbor ? binary_scan::Format::Cbor : binary_scan::Format::MsgPack;
+            return binary_scan::find(format, data, data + size, tokens_, value) &&
+                   test(value.kind, value.number, value.begin, value.end);
+        }
+        if (!supports(content_type))
+        {
+            return false;
+        }
+
+        const char *begin = reinterpret_cast<const char *>(data);
+        json_scan::Value value;
+        if (!json_scan::find(begin, begin + size, tokens_, value))
+        {
+            return false;
+        }
+        double number = 0;
+        if (value.kind == json_scan::Kind::Number && op_ != Op::Exists && !json_scan::to_number(value, number))
+        {
+            return false;
+        }
+        if (value.kind == json_scan::Kind::String && kind_ == json_scan::Kind::String && op_ != Op::Exists &&
+            std::memchr(value.begin, '\\', static_cast<size_t>(value.end - value.begin)) != nullptr)
+        {
+            std::string text;
+            return json_scan::unescape(value.begin, value.end, text) &&
+                   test(value.kind, number, text.data(), text.data() + text.size());
+        }
+        return test(value.kind, number, value.begin, value.end);
+    }
+
+    bool ContentFilter::test(json_scan::Kind kind, double number, const char *begin, const char *end) const
+    {
+        if (op_ == Op::Exists)
+        {
+            return true;
+        }
+        if (kind != kind_)
+        {
+            return op_ == Op::Ne;
+        }
+
+        switch (kind_)
+        {
+        case json_scan::Kind::Number:
+            return compare(number, number_);
+        case json_scan::Kind::String:
+        {
+            const size_t length = static_cast<size_t>(end - begin);
+            const int c = std::string::traits_type::compare(begin, text_.data(), std::min(length, text_.size()));
+            const int order = c != 0 ? c : (length < text_.size() ? -1 : length > text_.size() ? 1 : 0);
+            return compare(order, 0);
+        }
+        default:
+            return op_ == Op::Eq; // true/false/null 类型相同即相等
+        }
+    }
+
+} // namespace zmq_simple
@@ -0,0 +1,54 @@
+#ifndef ZMQ_SIMPLE_CONTENT_FILTER_HPP
+#define ZMQ_SIMPLE_CONTENT_FILTER_HPP
+
+#include "../include/zmq_simple.hpp"
+#include "json_scan.hpp"
+#include <string>
+#include <vector>
+
+namespace zmq_simple
+{
+    // 基于 JSON Pointer 的内容过滤条件，例如:
+    //   /temperature > 30
+    //   /sensor_id == "temp_sensor_01"
+    //   /alarm                 (字段存在即可)
+    // 直接在负载上求值 (JSON 文本、CBOR、MessagePack)，字段不存在时条件不成立。
+    // 其他编码无法求值，条件同样不成立
+    class ContentFilter
+    {
+    public:
+        // 表达式格式错误时返回 false
+        static bool parse(const std::string &expression, ContentFilter &filter);
+
+        static bool supports(ContentType content_type);
+
+        bool matches(ContentType content_type, const uint8_t *data, size_t size) const;
+
+    private:
+        enum class Op
+        {
+            Exists,
+            Eq,
+            Ne,
+            Lt,
+            Le,
+            Gt,
+            Ge,
+        };
+
+        template <typename T>
+        bool compare(const T &lhs, const T &rhs) const;
+
+        // String 的 [begin, end) 已反转义
+        bool test(json_scan::Kind kind, double number, const char *begin, const char *end) const;
+
+        std::vector<std::string> tokens_;
+        Op op_ = Op::Exists;
+        json_scan::Kind kind_ = json_scan::Kind::Null;
+        double number_ = 0;
+        std::string text_;
+    };
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_CONTENT_FILTER_HPP
@@ -0,0 +1,199 @@
+#include "delta.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace zmq_simple
+{
+    namespace delta
+    {
+        namespace
+        {
+            // 短于该长度的相同区间并入字面量，复制操作本身约占 4 字节
+            const size_t kMinCopy = 16;
+
+            void put_varint(std::vector<uint8_t> &out, uint64_t value)
+            {
+                while (value >= 0x80)
+                {
+                    out.push_back(static_cast<uint8_t>(value | 0x80));
+                    value >>= 7;
+                }
+                out.push_back(static_cast<uint8_t>(value));
+            }
+
+            bool get_varint(const uint8_t *&p, const uint8_t *end, uint64_t &value)
+            {
+                value = 0;
+                for (unsigned shift = 0; shift < 64 && p < end; shift += 7)
+                {
+                    const uint8_t byte = *p++;
+                    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                    if ((byte & 0x80) == 0)
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            inline uint64_t load64(const uint8_t *p)
+            {
+                uint64_t v;
+                std::memcpy(&v, p, sizeof(v));
+                return v;
+            }
+
+            // 从头比较，每次 8 字节
+            size_t equal_prefix(const uint8_t *a, const uint8_t *b, size_t size)
+            {
+                size_t i = 0;
+                while (i + 8 <= size && load64(a + i) == load64(b + i))
+                {
+                    i += 8;
+                }
+                while (i < size && a[i] == b[i])
+                {
+                    ++i;
+                }
+                return i;
+            }
+
+            // 从尾部向前比较，a_end / b_end 指向末尾之后
+            size_t equal_suffix(const uint8_t *a_end, const uint8_t *b_end, size_t size)
+            {
+                size_t i = 0;
+                while (i + 8 <= size && load64(a_end - i - 8) == load64(b_end - i - 8))
+                {
+                    i += 8;
+                }
+                while (i < size && a_end[-static_cast<ptrdiff_t>(i) - 1] == b_end[-static_cast<ptrdiff_t>(i) - 1])
+                {
+                    ++i;
+                }
+                return i;
+            }
+
+            void put_copy(std::vector<uint8_t> &out, size_t offset, size_t size)
+            {
+                if (size != 0)
+                {
+                    put_varint(out, static_cast<uint64_t>(size) << 1);
+                    put_varint(out, offset);
+                }
+            }
+
+            void put_literal(std::vector<uint8_t> &out, const uint8_t *data, size_t size)
+            {
+                if (size != 0)
+                {
+                    put_varint(out, (static_cast<uint64_t>(size) << 1) | 1);
+                    out.insert(out.end(), data, data + size);
+                }
+            }
+        } // namespace
+
+        void encode(const uint8_t *base, size_t base_size, const uint8_t *data, size_t size,
+                    std::vector<uint8_t> &out)
+        {
+            out.clear();
+            put_varint(out, size);
+
+            const size_t common = std::min(base_size, size);
+            const size_t prefix = equal_prefix(base, data, common);
+            const size_t suffix = equal_suffix(base + base_size, data + size, common - prefix);
+            put_copy(out, 0, prefix);
+
+            const size_t end = size - suffix;
+            if (base_size != size)
+            {
+                // 长度变化，中间部分无法按位置对齐
+                put_literal(out, data + prefix, end - prefix);
+            }
+            else
+            {
+                size_t pending = prefix; // 尚未输出的起点
+                size_t i = prefix;
+                while (i < end)
+                {
+                    const size_t same = equal_prefix(base + i, data + i, end - i);
+                    if (same >= kMinCopy)
+                    {
+                        put_literal(out, data + pending, i - pending);
+                        put_copy(out, i, same);
+                        i += same;
+                        pending = i;
+                        continue;
+                    }
+                    i += same;
+                    while (i < end && base[i] != data[i])
+                    {
+                        ++i;
+                    }
+                }
+                put_literal(out, data + pending, end - pending);
+            }
+
+            put_copy(out, base_size - suffix, suffix);
+        }
+
+        bool target_size(const uint8_t *patch, size_t patch_size, size_t &size)
+        {
+            uint64_t value = 0;
+            if (!get_varint(patch, patch + patch_size, value) || value > SIZE_MAX)
+            {
+                return false;
+            }
+            size = static_cast<size_t>(value);
+            return true;
+        }
+
+        bool apply(const uint8_t *base, size_t base_size, const uint8_t *patch, size_t patch_size,
+                   uint8_t *out, size_t size)
+        {
+            const uint8_t *p = patch;
+            const uint8_t *const end = patch + patch_size;
+            uint64_t value = 0;
+            if (!get_varint(p, end, value) || value != size)
+            {
+                return false;
+            }
+
+            size_t position = 0;
+            while (p < end)
+            {
+                uint64_t op = 0;
+                if (!get_varint(p, end, op))
+                {
+                    return false;
+                }
+                const uint64_t length = op >> 1;
+                if (length > size - position)
+                {
+                    return false;
+                }
+
+                if (op & 1)
+                {
+                    if (length > static_cast<uint64_t>(end - p))
+                    {
+                        return false;
+                    }
+                    std::memcpy(out + position, p, static_cast<size_t>(length));
+                    p += length;
+                }
+                else
+                {
+                    uint64_t offset = 0;
+                    if (!get_varint(p, end, offset) || offset > base_size || length > base_size - offset)
+                    {
+                        return false;
+                    }
+                    std::memcpy(out + position, base + offset, static_cast<size_t>(length));
+                }
+                position += static_cast<size_t>(length);
+            }
+            return position == size;
+        }
+    } // namespace delta
+
+} // namespace zmq_simple
@@ -0,0 +1,32 @@
+#ifndef ZMQ_SIMPLE_DELTA_HPP
+#define ZMQ_SIMPLE_DELTA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace zmq_simple
+{
+    // 字节级差分: 新版本表示为从旧版本复制的区间与新字节的序列
+    // 格式: [新长度 varint] 后接若干操作
+    //   复制: varint(len << 1)，varint(旧版本中的偏移)
+    //   字面: varint(len << 1 | 1)，len 个字节
+    // 先取公共前缀与公共后缀，中间部分等长时逐段比较，不等长时整体作为字面量。
+    // 因此单处修改 (含长度变化，如 JSON 中数字变长) 和多处等长修改都能得到很小的补丁
+    namespace delta
+    {
+        // 补丁写入 out (覆盖原内容)
+        void encode(const uint8_t *base, size_t base_size, const uint8_t *data, size_t size,
+                    std::vector<uint8_t> &out);
+
+        // 新长度，补丁无效时返回 false
+        bool target_size(const uint8_t *patch, size_t patch_size, size_t &size);
+
+        // out 长度须为 target_size 的结果，且不能与 base 重叠
+        bool apply(const uint8_t *base, size_t base_size, const uint8_t *patch, size_t patch_size,
+                   uint8_t *out, size_t size);
+    } // namespace delta
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_DELTA_HPP
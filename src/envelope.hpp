@@ -0,0 +1,96 @@
+#ifndef ZMQ_SIMPLE_ENVELOPE_HPP
+#define ZMQ_SIMPLE_ENVELOPE_HPP
+
+#include <cstdint>
+#include <cstring>
+
+namespace zmq_simple
+{
+    // 扩展消息格式: [topic][envelope][payload]
+    // 普通消息仍为两帧 [topic][payload]，不带 envelope，保持与旧版本兼容
+    namespace envelope
+    {
+        const uint8_t kMagic = 0x5A; // 'Z'
+        const uint8_t kVersion = 1;
+
+        enum Flags : uint16_t
+        {
+            FLAG_COMPRESSED = 1 << 0,
+            FLAG_STREAM_CHUNK = 1 << 1, // 流式传输的数据块
+            FLAG_STREAM_END = 1 << 2,   // 流的最后一块
+            FLAG_MEMFD = 1 << 3,        // 负载为 memfd 引用 (MemfdRef)，数据经旁路传递
+            FLAG_DELTA = 1 << 4,        // 负载为相对上一版本的差分，见 delta.hpp
+            FLAG_KEYFRAME = 1 << 5,     // 差分模式下的完整版本
+        };
+
+#pragma pack(push, 1)
+        struct Header
+        {
+            uint8_t magic;
+            uint8_t version;
+            uint16_t flags;
+            uint32_t raw_size; // 解码后的负载长度
+            uint32_t dict_id;  // 压缩字典 ID，0 表示无字典
+            uint8_t content_type; // ContentType
+            uint8_t reserved[3];
+            uint64_t stream_id; // 流 ID，仅数据块使用；差分消息中为发布端的版本链 ID
+            uint64_t sequence;  // 块序号，从 0 开始；差分消息中为版本号，差分基于 sequence - 1
+        };
+
+
+        struct MemfdRef
+        {
+            uint64_t token;
+            uint64_t size;
+        };
+#pragma pack(pop)
+
+        inline Header make_header(uint16_t flags, uint8_t content_type = 0)
+        {
+            Header header;
+            std::memset(&header, 0, sizeof(header));
+            header.magic = kMagic;
+            header.version = kVersion;
+            header.flags = flags;
+            header.content_type = content_type;
+            return header;
+        }
+
+        inline bool parse_header(const void *data, size_t size, Header &header)
+        {
+            if (size < sizeof(Header))
+            {
+                return false;
+            }
+            std::memcpy(&header, data, sizeof(Header));
+            return header.magic == kMagic && header.version == kVersion;
+        }
+    } // namespace envelope
+
+    // 控制通道: 订阅端 DEALER -> 发布端 ROUTER，用于流式传输的信用回馈与差分关键帧请求
+    namespace control
+    {
+        enum Type : uint8_t
+        {
+            CREDIT = 1,      // value 为已消费到的块序号 + 1
+            SUBSCRIBE = 2,   // 包后紧跟 Topic 前缀
+            UNSUBSCRIBE = 3, // 包后紧跟 Topic 前缀
+            BYE = 4,
+            KEYFRAME = 5,    // 请求差分 Topic 的完整版本，包后紧跟 Topic 前缀
+        };
+
+#pragma pack(push, 1)
+        struct Packet
+        {
+            uint8_t type;
+            uint8_t reserved[3];
+            uint32_t window; // 订阅端允许的未确认块数，每个包都携带，发布端据此自动登记
+            uint64_t stream_id;
+            uint64_t value;
+        };
+#pragma pack(pop)
+    } // namespace control
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_ENVELOPE_HPP
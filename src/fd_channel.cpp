@@ -0,0 +1,467 @@
+#include "fd_channel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace zmq_simple
+{
+    namespace fd_channel
+    {
+#ifdef __linux__
+        namespace
+        {
+            enum RequestType : uint8_t
+            {
+                SUBSCRIBE = 1,
+                UNSUBSCRIBE = 2,
+            };
+
+#pragma pack(push, 1)
+            struct Announcement
+            {
+                uint64_t token;
+                uint64_t size;
+            };
+#pragma pack(pop)
+
+            const size_t kMaxPending = 64;
+
+            sockaddr_un make_address(const std::string &path)
+            {
+                sockaddr_un addr;
+                std::memset(&addr, 0, sizeof(addr));
+                addr.sun_family = AF_UNIX;
+                if (path.size() >= sizeof(addr.sun_path))
+                {
+                    throw std::runtime_error("Socket path too long: " + path);
+                }
+                std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+                return addr;
+            }
+
+            bool write_all(int fd, const uint8_t *data, size_t size)
+            {
+                while (size > 0)
+                {
+                    const ssize_t n = ::write(fd, data, size);
+                    if (n < 0)
+                    {
+                        if (errno == EINTR)
+                        {
+                            continue;
+                        }
+                        return false;
+                    }
+                    data += n;
+                    size -= static_cast<size_t>(n);
+                }
+                return true;
+            }
+
+            bool matches(const std::multiset<std::string> &topics, const std::string &topic)
+            {
+                for (const std::string &prefix : topics)
+                {
+                    if (topic.compare(0, prefix.size(), prefix) == 0)
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+        } // namespace
+
+        bool supported()
+        {
+            return true;
+        }
+
+        Server::Server(const std::string &path)
+            : path_(path), listen_fd_(-1), next_token_(0)
+        {
+            listen_fd_ = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (listen_fd_ < 0)
+            {
+                throw std::runtime_error("Failed to create fd channel: " + std::string(std::strerror(errno)));
+            }
+
+            // 与 ipc:// 一致，覆盖残留的套接字文件
+            ::unlink(path_.c_str());
+            const sockaddr_un addr = make_address(path_);
+            if (::bind(listen_fd_, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0 ||
+                ::listen(listen_fd_, 64) != 0)
+            {
+                const std::string error = std::strerror(errno);
+                ::close(listen_fd_);
+                throw std::runtime_error("Failed to bind fd channel: " + error);
+            }
+        }
+
+        Server::~Server()
+        {
+            for (Client &client : clients_)
+            {
+                ::close(client.fd);
+            }
+            ::close(listen_fd_);
+            ::unlink(path_.c_str());
+        }
+
+        void Server::accept_clients()
+        {
+            while (true)
+            {
+                const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0)
+                {
+                    break;
+                }
+                clients_.push_back(Client{fd, std::multiset<std::string>()});
+            }
+
+            for (size_t i = 0; i < clients_.size();)
+            {
+                read_requests(clients_[i]);
+                if (clients_[i].fd < 0)
+                {
+                    clients_.erase(clients_.begin() + i);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+
+        void Server::read_requests(Client &client)
+        {
+            char buffer[1024];
+            while (true)
+            {
+                const ssize_t n = ::recv(client.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+                if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR))
+                {
+                    // 订阅端已断开
+                    ::close(client.fd);
+                    client.fd = -1;
+                    return;
+                }
+                if (n < 0)
+                {
+                    return;
+                }
+
+                const std::string topic(buffer + 1, static_cast<size_t>(n) - 1);
+                if (buffer[0] == SUBSCRIBE)
+                {
+                    client.topics.insert(topic);
+                }
+                else if (buffer[0] == UNSUBSCRIBE)
+                {
+                    auto it = client.topics.find(topic);
+                    if (it != client.topics.end())
+                    {
+                        client.topics.erase(it);
+                    }
+                }
+            }
+        }
+
+        bool Server::publish(const std::string &topic, const void *data, size_t size, uint64_t &token)
+        {
+            accept_clients();
+
+            // 没有客户端订阅该 Topic 时不创建 memfd，由调用方按普通消息发送
+            bool subscribed = false;
+            for (const Client &client : clients_)
+            {
+                subscribed = subscribed || matches(client.topics, topic);
+            }
+            if (!subscribed)
+            {
+                return false;
+            }
+
+            const int memfd = ::memfd_create("zmq_simple", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+            if (memfd < 0)
+            {
+                return false;
+            }
+
+            // 封印后订阅端只能读取，发布端也无法再修改
+            if (!write_all(memfd, static_cast<const uint8_t *>(data), size) ||
+                ::fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0)
+            {
+                ::close(memfd);
+                return false;
+            }
+
+            token = ++next_token_;
+            Announcement announcement = {token, size};
+
+            for (Client &client : clients_)
+            {
+                if (!matches(client.topics, topic))
+                {
+                    continue;
+                }
+
+                iovec iov;
+                iov.iov_base = &announcement;
+                iov.iov_len = sizeof(announcement);
+
+                char control[CMSG_SPACE(sizeof(int))];
+                std::memset(control, 0, sizeof(control));
+
+                msghdr msg;
+                std::memset(&msg, 0, sizeof(msg));
+                msg.msg_iov = &iov;
+                msg.msg_iovlen = 1;
+                msg.msg_control = control;
+                msg.msg_controllen = sizeof(control);
+
+                cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+                cmsg->cmsg_level = SOL_SOCKET;
+                cmsg->cmsg_type = SCM_RIGHTS;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+                std::memcpy(CMSG_DATA(cmsg), &memfd, sizeof(int));
+
+                // 订阅端来不及读取时跳过，该订阅端会丢弃这条消息
+                ::sendmsg(client.fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+            }
+
+            ::close(memfd);
+            return true;
+        }
+
+        Client::Client(const std::string &path)
+            : path_(path), fd_(-1)
+        {
+            ensure_connected();
+        }
+
+        Client::~Client()
+        {
+            disconnect();
+        }
+
+        void Client::disconnect()
+        {
+            for (const auto &entry : pending_)
+            {
+                ::close(entry.second);
+            }
+            pending_.clear();
+            if (fd_ >= 0)
+            {
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+
+        bool Client::ensure_connected()
+        {
+            if (fd_ >= 0)
+            {
+                return true;
+            }
+
+            fd_ = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+            if (fd_ < 0)
+            {
+                return false;
+            }
+            const sockaddr_un addr = make_address(path_);
+            if (::connect(fd_, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0)
+            {
+                // 发布端尚未启动，稍后重试
+                ::close(fd_);
+                fd_ = -1;
+                return false;
+            }
+
+            for (const std::string &topic : topics_)
+            {
+                send_request(SUBSCRIBE, topic);
+            }
+            return true;
+        }
+
+        void Client::send_request(uint8_t type, const std::string &topic)
+        {
+            if (fd_ < 0)
+            {
+                return;
+            }
+            std::string request(1, static_cast<char>(type));
+            request += topic;
+            ::send(fd_, request.data(), request.size(), MSG_NOSIGNAL);
+        }
+
+        void Client::subscribe(const std::string &topic)
+        {
+            topics_.insert(topic);
+            if (ensure_connected())
+            {
+                send_request(SUBSCRIBE, topic);
+            }
+        }
+
+        void Client::unsubscribe(const std::string &topic)
+        {
+            auto it = topics_.find(topic);
+            if (it != topics_.end())
+            {
+                topics_.erase(it);
+            }
+            send_request(UNSUBSCRIBE, topic);
+        }
+
+        std::shared_ptr<void> Client::map(uint64_t token, uint64_t size, const uint8_t *&data, int timeout_ms)
+        {
+            if (!ensure_connected())
+            {
+                return nullptr;
+            }
+
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+            int memfd = -1;
+
+            // 令牌单调递增，小于本次令牌的描述符对应的 ZeroMQ 消息已在高水位被丢弃，不会再被请求
+            auto found = pending_.begin();
+            while (found != pending_.end() && found->first < token)
+            {
+                ::close(found->second);
+                found = pending_.erase(found);
+            }
+            if (found != pending_.end() && found->first == token)
+            {
+                memfd = found->second;
+                pending_.erase(found);
+            }
+
+            while (memfd < 0)
+            {
+                const int left = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                      deadline - std::chrono::steady_clock::now())
+                                                      .count());
+                // 超时为 0 或已到期时仍检查一次已在套接字中的描述符
+                pollfd pfd = {fd_, POLLIN, 0};
+                if (::poll(&pfd, 1, std::max(0, left)) <= 0)
+                {
+                    return nullptr;
+                }
+
+                Announcement announcement;
+                iovec iov;
+                iov.iov_base = &announcement;
+                iov.iov_len = sizeof(announcement);
+
+                char control[CMSG_SPACE(sizeof(int))];
+                msghdr msg;
+                std::memset(&msg, 0, sizeof(msg));
+                msg.msg_iov = &iov;
+                msg.msg_iovlen = 1;
+                msg.msg_control = control;
+                msg.msg_controllen = sizeof(control);
+
+                const ssize_t n = ::recvmsg(fd_, &msg, MSG_CMSG_CLOEXEC);
+                if (n <= 0)
+                {
+                    // 发布端已退出
+                    disconnect();
+                    return nullptr;
+                }
+
+                cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+                if (n != sizeof(announcement) || cmsg == nullptr || cmsg->cmsg_type != SCM_RIGHTS)
+                {
+                    continue;
+                }
+                int received = -1;
+                std::memcpy(&received, CMSG_DATA(cmsg), sizeof(int));
+
+                if (announcement.token == token)
+                {
+                    memfd = received;
+                }
+                else if (announcement.token > token && pending_.size() < kMaxPending)
+                {
+                    pending_[announcement.token] = received;
+                }
+                else
+                {
+                    ::close(received); // 对应的消息已错过
+                }
+            }
+
+            struct stat st;
+            if (::fstat(memfd, &st) != 0 || static_cast<uint64_t>(st.st_size) != size)
+            {
+                ::close(memfd);
+                return nullptr;
+            }
+
+            void *addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, memfd, 0);
+            ::close(memfd);
+            if (addr == MAP_FAILED)
+            {
+                return nullptr;
+            }
+
+            data = static_cast<const uint8_t *>(addr);
+            return std::shared_ptr<void>(addr, [size](void *p)
+                                         { ::munmap(p, size); });
+        }
+
+#else
+        bool supported()
+        {
+            return false;
+        }
+
+        Server::Server(const std::string &path)
+            : path_(path), listen_fd_(-1), next_token_(0)
+        {
+            throw std::runtime_error("memfd payload handoff is only supported on Linux");
+        }
+
+        Server::~Server() {}
+
+        bool Server::publish(const std::string &, const void *, size_t, uint64_t &)
+        {
+            return false;
+        }
+
+        Client::Client(const std::string &path)
+            : path_(path), fd_(-1)
+        {
+            throw std::runtime_error("memfd payload handoff is only supported on Linux");
+        }
+
+        Client::~Client() {}
+
+        void Client::subscribe(const std::string &) {}
+
+        void Client::unsubscribe(const std::string &) {}
+
+        std::shared_ptr<void> Client::map(uint64_t, uint64_t, const uint8_t *&, int)
+        {
+            return nullptr;
+        }
+#endif
+    } // namespace fd_channel
+
+} // namespace zmq_simple
@@ -0,0 +1,77 @@
+#ifndef ZMQ_SIMPLE_FD_CHANNEL_HPP
+#define ZMQ_SIMPLE_FD_CHANNEL_HPP
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace zmq_simple
+{
+    // 大消息旁路: 负载写入 sealed memfd，描述符经 Unix 域套接字 (SCM_RIGHTS) 传给订阅端，
+    // ZeroMQ 消息中只携带 token。仅支持 Linux
+    namespace fd_channel
+    {
+        bool supported();
+
+        class Server
+        {
+        public:
+            explicit Server(const std::string &path);
+            ~Server();
+
+            Server(const Server &) = delete;
+            Server &operator=(const Server &) = delete;
+
+            // 写入 memfd 并发送给订阅了 topic 的客户端，成功时返回 token。
+            // 没有客户端订阅 topic 或 memfd 创建失败时返回 false
+            bool publish(const std::string &topic, const void *data, size_t size, uint64_t &token);
+
+        private:
+            struct Client
+            {
+                int fd;
+                std::multiset<std::string> topics;
+            };
+
+            void accept_clients();
+            void read_requests(Client &client);
+
+            std::string path_;
+            int listen_fd_;
+            uint64_t next_token_;
+            std::vector<Client> clients_;
+        };
+
+        class Client
+        {
+        public:
+            explicit Client(const std::string &path);
+            ~Client();
+
+            Client(const Client &) = delete;
+            Client &operator=(const Client &) = delete;
+
+            void subscribe(const std::string &topic);
+            void unsubscribe(const std::string &topic);
+
+            // 等待 token 对应的描述符并只读映射，返回的 holder 负责 munmap
+            std::shared_ptr<void> map(uint64_t token, uint64_t size, const uint8_t *&data, int timeout_ms);
+
+        private:
+            bool ensure_connected();
+            void send_request(uint8_t type, const std::string &topic);
+            void disconnect();
+
+            std::string path_;
+            int fd_;
+            std::multiset<std::string> topics_;
+            std::map<uint64_t, int> pending_; // 先于 ZeroMQ 消息到达的描述符
+        };
+    } // namespace fd_channel
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_FD_CHANNEL_HPP
@@ -0,0 +1,267 @@
+#include "json_index.hpp"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ZMQ_SIMPLE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace zmq_simple
+{
+    namespace json_index
+    {
+        namespace
+        {
+            const size_t kBlockSize = 64;
+
+            // 一个 64 字节块的字符分类，每个比特对应一个字节
+            struct Masks
+            {
+                uint64_t quote;
+                uint64_t backslash;
+                uint64_t op; // { } [ ] : ,
+            };
+
+            // 块之间传递的状态
+            struct State
+            {
+                uint64_t escape_carry = 0; // 上一块以未配对的反斜杠结尾
+                uint64_t in_string = 0;    // 上一块结束时仍在字符串内 (全 0 或全 1)
+            };
+
+            inline bool is_op(uint8_t c)
+            {
+                return c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+            }
+
+            inline unsigned count_trailing_zeros(uint64_t v)
+            {
+#ifdef __GNUC__
+                return static_cast<unsigned>(__builtin_ctzll(v));
+#else
+                unsigned n = 0;
+                while ((v & 1) == 0)
+                {
+                    v >>= 1;
+                    ++n;
+                }
+                return n;
+#endif
+            }
+
+            inline size_t count_bits(uint64_t v)
+            {
+#ifdef __GNUC__
+                return static_cast<size_t>(__builtin_popcountll(v));
+#else
+                size_t n = 0;
+                for (; v != 0; v &= v - 1)
+                {
+                    ++n;
+                }
+                return n;
+#endif
+            }
+
+            void classify_scalar(const uint8_t *block, Masks &masks)
+            {
+                masks = Masks{0, 0, 0};
+                for (size_t i = 0; i < kBlockSize; ++i)
+                {
+                    const uint8_t c = block[i];
+                    const uint64_t bit = uint64_t(1) << i;
+                    if (c == '"')
+                    {
+                        masks.quote |= bit;
+                    }
+                    else if (c == '\\')
+                    {
+                        masks.backslash |= bit;
+                    }
+                    else if (is_op(c))
+                    {
+                        masks.op |= bit;
+                    }
+                }
+            }
+
+#ifdef ZMQ_SIMPLE_X86_SIMD
+            __attribute__((target("sse4.2"))) void classify_sse42(const uint8_t *block, Masks &masks)
+            {
+                const __m128i ops = _mm_setr_epi8('{', '}', '[', ']', ':', ',', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+                const __m128i quote = _mm_set1_epi8('"');
+                const __m128i backslash = _mm_set1_epi8('\\');
+                masks = Masks{0, 0, 0};
+                for (size_t i = 0; i < kBlockSize; i += 16)
+                {
+                    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+                    // PCMPESTRM: 逐字节判断是否属于 ops 集合，显式长度使负载中的 0 字节不影响结果
+                    const __m128i op = _mm_cmpestrm(ops, 6, v, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_UNIT_MASK);
+                    masks.op |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(op))) << i;
+                    masks.quote |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)))) << i;
+                    masks.backslash |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)))) << i;
+                }
+            }
+
+            __attribute__((target("avx2"))) void classify_avx2(const uint8_t *block, Masks &masks)
+            {
+                const __m256i quote = _mm256_set1_epi8('"');
+                const __m256i backslash = _mm256_set1_epi8('\\');
+                const __m256i open_brace = _mm256_set1_epi8('{');
+                const __m256i close_brace = _mm256_set1_epi8('}');
+                const __m256i open_bracket = _mm256_set1_epi8('[');
+                const __m256i close_bracket = _mm256_set1_epi8(']');
+                const __m256i colon = _mm256_set1_epi8(':');
+                const __m256i comma = _mm256_set1_epi8(',');
+                masks = Masks{0, 0, 0};
+                for (size_t i = 0; i < kBlockSize; i += 32)
+                {
+                    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + i));
+                    const __m256i braces = _mm256_or_si256(_mm256_cmpeq_epi8(v, open_brace), _mm256_cmpeq_epi8(v, close_brace));
+                    const __m256i brackets = _mm256_or_si256(_mm256_cmpeq_epi8(v, open_bracket), _mm256_cmpeq_epi8(v, close_bracket));
+                    const __m256i separators = _mm256_or_si256(_mm256_cmpeq_epi8(v, colon), _mm256_cmpeq_epi8(v, comma));
+                    const __m256i op = _mm256_or_si256(_mm256_or_si256(braces, brackets), separators);
+                    masks.op |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(op))) << i;
+                    masks.quote |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)))) << i;
+                    masks.backslash |= uint64_t(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash)))) << i;
+                }
+            }
+#endif
+
+            // 被转义的字符: 反斜杠很少见，逐个处理即可
+            inline uint64_t escaped_chars(uint64_t backslash, State &state)
+            {
+                uint64_t escaped = state.escape_carry;
+                state.escape_carry = 0;
+                while (backslash != 0)
+                {
+                    const unsigned i = count_trailing_zeros(backslash);
+                    backslash &= backslash - 1;
+                    if ((escaped >> i) & 1)
+                    {
+                        continue; // 本身被转义的反斜杠
+                    }
+                    if (i == 63)
+                    {
+                        state.escape_carry = 1;
+                    }
+                    else
+                    {
+                        escaped |= uint64_t(1) << (i + 1);
+                    }
+                }
+                return escaped;
+            }
+
+            // 前缀异或: 开引号 (含) 到闭引号 (不含) 之间为 1
+            inline uint64_t prefix_xor(uint64_t v)
+            {
+                v ^= v << 1;
+                v ^= v << 2;
+                v ^= v << 4;
+                v ^= v << 8;
+                v ^= v << 16;
+                v ^= v << 32;
+                return v;
+            }
+
+            template <void (*Classify)(const uint8_t *, Masks &)>
+            bool build_blocks(const char *data, size_t size, uint32_t *out, size_t &count)
+            {
+                count = 0;
+                if (size > 0xFFFFFFFFu)
+                {
+                    return false;
+                }
+
+                const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+                uint32_t *const first = out;
+                State state;
+                uint8_t tail[kBlockSize];
+
+                for (size_t base = 0; base < size; base += kBlockSize)
+                {
+                    const uint8_t *block = bytes + base;
+                    if (size - base < kBlockSize)
+                    {
+                        // 最后不足一块时以空格补齐
+                        std::memset(tail, ' ', sizeof(tail));
+                        std::memcpy(tail, block, size - base);
+                        block = tail;
+                    }
+
+                    Masks masks;
+                    Classify(block, masks);
+
+                    const uint64_t quotes = masks.quote & ~escaped_chars(masks.backslash, state);
+                    const uint64_t in_string = prefix_xor(quotes) ^ state.in_string;
+                    state.in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+                    // 每次无条件写 4 个位置以减少分支，多写的部分由下一轮覆盖，
+                    // 因此输出空间须比结构字符数多出一块
+                    uint64_t structurals = (masks.op & ~in_string) | quotes;
+                    const uint32_t offset = static_cast<uint32_t>(base);
+                    const size_t found = count_bits(structurals);
+                    uint32_t *next = out + found;
+                    while (structurals != 0)
+                    {
+                        out[0] = offset + count_trailing_zeros(structurals);
+                        structurals &= structurals - 1;
+                        out[1] = offset + count_trailing_zeros(structurals | (uint64_t(1) << 63));
+                        structurals &= structurals - 1;
+                        out[2] = offset + count_trailing_zeros(structurals | (uint64_t(1) << 63));
+                        structurals &= structurals - 1;
+                        out[3] = offset + count_trailing_zeros(structurals | (uint64_t(1) << 63));
+                        structurals &= structurals - 1;
+                        out += 4;
+                    }
+                    out = next;
+                }
+                count = static_cast<size_t>(out - first);
+                return state.in_string == 0;
+            }
+        } // namespace
+
+        Isa active_isa()
+        {
+#ifdef ZMQ_SIMPLE_X86_SIMD
+            static const Isa isa = __builtin_cpu_supports("avx2")     ? Isa::Avx2
+                                   : __builtin_cpu_supports("sse4.2") ? Isa::Sse42
+                                                                      : Isa::Scalar;
+            return isa;
+#else
+            return Isa::Scalar;
+#endif
+        }
+
+        bool build(const char *data, size_t size, uint32_t *out, size_t &count)
+        {
+            return build(data, size, out, count, active_isa());
+        }
+
+        bool build(const char *data, size_t size, uint32_t *out, size_t &count, Isa isa)
+        {
+            switch (isa)
+            {
+#ifdef ZMQ_SIMPLE_X86_SIMD
+            case Isa::Avx2:
+                return build_blocks<classify_avx2>(data, size, out, count);
+            case Isa::Sse42:
+                return build_blocks<classify_sse42>(data, size, out, count);
+#endif
+            default:
+                return build_blocks<classify_scalar>(data, size, out, count);
+            }
+        }
+
+        bool build(const char *data, size_t size, std::vector<uint32_t> &index)
+        {
+            index.resize(capacity_for(size));
+            size_t count = 0;
+            const bool ok = build(data, size, index.data(), count);
+            index.resize(count);
+            return ok;
+        }
+    } // namespace json_index
+
+} // namespace zmq_simple
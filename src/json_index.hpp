@@ -0,0 +1,43 @@
+#ifndef ZMQ_SIMPLE_JSON_INDEX_HPP
+#define ZMQ_SIMPLE_JSON_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace zmq_simple
+{
+    // JSON 结构索引: 按 64 字节块找出字符串外的 { } [ ] : , 以及未转义的引号，
+    // 记录其偏移。x86 上按 CPU 支持选择 AVX2 / SSE4.2 实现，其他平台使用标量实现
+    namespace json_index
+    {
+        enum class Isa
+        {
+            Scalar,
+            Sse42,
+            Avx2,
+        };
+
+        // 当前 CPU 上使用的实现
+        Isa active_isa();
+
+        // 输出空间: 每字节至多一个位置，另加一块的余量
+        inline size_t capacity_for(size_t size)
+        {
+            return size + 64;
+        }
+
+        // 位置写入 out (至少 capacity_for(size) 个)，count 为位置数。
+        // 字符串未闭合或长度超过 4GB 时返回 false
+        bool build(const char *data, size_t size, uint32_t *out, size_t &count);
+
+        // 指定实现，用于对比测试
+        bool build(const char *data, size_t size, uint32_t *out, size_t &count, Isa isa);
+
+        // 便捷版本，每次调用都会调整 index 的长度
+        bool build(const char *data, size_t size, std::vector<uint32_t> &index);
+    } // namespace json_index
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_JSON_INDEX_HPP
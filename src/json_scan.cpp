@@ -0,0 +1,432 @@
+#include "json_scan.hpp"
+#include <cstdlib>
+#include <cstring>
+
+namespace zmq_simple
+{
+    namespace json_scan
+    {
+        namespace
+        {
+            inline const char *skip_ws(const char *p, const char *end)
+            {
+                while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+                {
+                    ++p;
+                }
+                return p;
+            }
+
+            // p 指向开引号之后，返回闭引号位置；前面有奇数个反斜杠的引号是转义的
+            const char *string_end(const char *p, const char *end)
+            {
+                while (p < end)
+                {
+                    const char *q = static_cast<const char *>(std::memchr(p, '"', static_cast<size_t>(end - p)));
+                    if (q == nullptr)
+                    {
+                        return nullptr;
+                    }
+                    size_t backslashes = 0;
+                    for (const char *b = q; b > p && b[-1] == '\\'; --b)
+                    {
+                        ++backslashes;
+                    }
+                    if (backslashes % 2 == 0)
+                    {
+                        return q;
+                    }
+                    p = q + 1;
+                }
+                return nullptr;
+            }
+
+            // p 指向 '{' 或 '['，返回匹配的闭括号之后
+            const char *container_end(const char *p, const char *end)
+            {
+                size_t depth = 0;
+                while (p < end)
+                {
+                    switch (*p)
+                    {
+                    case '"':
+                        p = string_end(p + 1, end);
+                        if (p == nullptr)
+                        {
+                            return nullptr;
+                        }
+                        break;
+                    case '{':
+                    case '[':
+                        ++depth;
+                        break;
+                    case '}':
+                    case ']':
+                        if (--depth == 0)
+                        {
+                            return p + 1;
+                        }
+                        break;
+                    default:
+                        break;
+                    }
+                    ++p;
+                }
+                return nullptr;
+            }
+
+            bool literal(const char *p, const char *end, const char *word, size_t length)
+            {
+                return static_cast<size_t>(end - p) >= length && std::memcmp(p, word, length) == 0;
+            }
+
+            bool key_equals(const char *begin, const char *end, const std::string &token)
+            {
+                const size_t length = static_cast<size_t>(end - begin);
+                if (std::memchr(begin, '\\', length) == nullptr)
+                {
+                    return length == token.size() && std::memcmp(begin, token.data(), length) == 0;
+                }
+                std::string key;
+                return unescape(begin, end, key) && key == token;
+            }
+
+            int hex_digit(char c)
+            {
+                if (c >= '0' && c <= '9')
+                {
+                    return c - '0';
+                }
+                if (c >= 'a' && c <= 'f')
+                {
+                    return c - 'a' + 10;
+                }
+                if (c >= 'A' && c <= 'F')
+                {
+                    return c - 'A' + 10;
+                }
+                return -1;
+            }
+
+            bool read_hex4(const char *p, const char *end, uint32_t &code)
+            {
+                if (end - p < 4)
+                {
+                    return false;
+                }
+                code = 0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    const int d = hex_digit(p[i]);
+                    if (d < 0)
+                    {
+                        return false;
+                    }
+                    code = (code << 4) | static_cast<uint32_t>(d);
+                }
+                return true;
+            }
+
+            void append_utf8(uint32_t code, std::string &out)
+            {
+                if (code < 0x80)
+                {
+                    out += static_cast<char>(code);
+                }
+                else if (code < 0x800)
+                {
+                    out += static_cast<char>(0xC0 | (code >> 6));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else if (code < 0x10000)
+                {
+                    out += static_cast<char>(0xE0 | (code >> 12));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else
+                {
+                    out += static_cast<char>(0xF0 | (code >> 18));
+                    out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+            }
+        } // namespace
+
+        bool parse_index(const std::string &token, size_t &index)
+        {
+            if (token.empty() || token.size() > 18 || (token.size() > 1 && token[0] == '0'))
+            {
+                return false;
+            }
+            index = 0;
+            for (char c : token)
+            {
+                if (c < '0' || c > '9')
+                {
+                    return false;
+                }
+                index = index * 10 + static_cast<size_t>(c - '0');
+            }
+            return true;
+        }
+
+        bool split_pointer(const std::string &pointer, std::vector<std::string> &tokens)
+        {
+            tokens.clear();
+            if (pointer.empty())
+            {
+                return true; // 整个文档
+            }
+            if (pointer[0] != '/')
+            {
+                return false;
+            }
+            std::string token;
+            for (size_t i = 1; i <= pointer.size(); ++i)
+            {
+                if (i == pointer.size() || pointer[i] == '/')
+                {
+                    tokens.push_back(token);
+                    token.clear();
+                }
+                else if (pointer[i] == '~')
+                {
+                    if (i + 1 >= pointer.size() || (pointer[i + 1] != '0' && pointer[i + 1] != '1'))
+                    {
+                        return false;
+                    }
+                    token += pointer[i + 1] == '0' ? '~' : '/';
+                    ++i;
+                }
+                else
+                {
+                    token += pointer[i];
+                }
+            }
+            return true;
+        }
+
+        bool read_value(const char *begin, const char *end, Value &value, const char *&next)
+        {
+            const char *p = skip_ws(begin, end);
+            if (p == end)
+            {
+                return false;
+            }
+
+            switch (*p)
+            {
+            case '"':
+            {
+                const char *q = string_end(p + 1, end);
+                if (q == nullptr)
+                {
+                    return false;
+                }
+                value = Value{Kind::String, p + 1, q};
+                next = q + 1;
+                return true;
+            }
+            case '{':
+            case '[':
+            {
+                const char *q = container_end(p, end);
+                if (q == nullptr)
+                {
+                    return false;
+                }
+                value = Value{*p == '{' ? Kind::Object : Kind::Array, p, q};
+                next = q;
+                return true;
+            }
+            case 't':
+                value = Value{Kind::True, p, p + 4};
+                next = p + 4;
+                return literal(p, end, "true", 4);
+            case 'f':
+                value = Value{Kind::False, p, p + 5};
+                next = p + 5;
+                return literal(p, end, "false", 5);
+            case 'n':
+                value = Value{Kind::Null, p, p + 4};
+                next = p + 4;
+                return literal(p, end, "null", 4);
+            default:
+                break;
+            }
+
+            const char *q = p;
+            while (q < end && ((*q >= '0' && *q <= '9') || *q == '-' || *q == '+' || *q == '.' || *q == 'e' || *q == 'E'))
+            {
+                ++q;
+            }
+            if (q == p)
+            {
+                return false;
+            }
+            value = Value{Kind::Number, p, q};
+            next = q;
+            return true;
+        }
+
+        bool find(const char *begin, const char *end, const std::vector<std::string> &tokens, Value &value)
+        {
+            const char *p = begin;
+            const char *next = nullptr;
+            Value skipped;
+
+            for (const std::string &token : tokens)
+            {
+                p = skip_ws(p, end);
+                if (p == end)
+                {
+                    return false;
+                }
+
+                if (*p == '{')
+                {
+                    p = skip_ws(p + 1, end);
+                    while (true)
+                    {
+                        if (p == end || *p != '"')
+                        {
+                            return false; // 包括空对象和已到达 '}'
+                        }
+                        const char *key = p + 1;
+                        const char *key_end = string_end(key, end);
+                        if (key_end == nullptr)
+                        {
+                            return false;
+                        }
+                        p = skip_ws(key_end + 1, end);
+                        if (p == end || *p != ':')
+                        {
+                            return false;
+                        }
+                        ++p;
+                        if (key_equals(key, key_end, token))
+                        {
+                            break;
+                        }
+                        if (!read_value(p, end, skipped, next))
+                        {
+                            return false;
+                        }
+                        p = skip_ws(next, end);
+                        if (p == end || *p != ',')
+                        {
+                            return false;
+                        }
+                        p = skip_ws(p + 1, end);
+                    }
+                }
+                else if (*p == '[')
+                {
+                    size_t index = 0;
+                    if (!parse_index(token, index))
+                    {
+                        return false;
+                    }
+                    ++p;
+                    for (size_t i = 0; i < index; ++i)
+                    {
+                        if (!read_value(p, end, skipped, next))
+                        {
+                            return false;
+                        }
+                        p = skip_ws(next, end);
+                        if (p == end || *p != ',')
+                        {
+                            return false;
+                        }
+                        ++p;
+                    }
+                    p = skip_ws(p, end);
+                    if (p == end || *p == ']')
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            return read_value(p, end, value, next);
+        }
+
+        bool unescape(const char *begin, const char *end, std::string &out)
+        {
+            out.clear();
+            out.reserve(static_cast<size_t>(end - begin));
+            for (const char *p = begin; p < end; ++p)
+            {
+                if (*p != '\\')
+                {
+                    out += *p;
+                    continue;
+                }
+                if (++p == end)
+                {
+                    return false;
+                }
+                switch (*p)
+                {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u':
+                {
+                    uint32_t code = 0;
+                    if (!read_hex4(p + 1, end, code))
+                    {
+                        return false;
+                    }
+                    p += 4;
+                    // 代理对
+                    if (code >= 0xD800 && code <= 0xDBFF)
+                    {
+                        uint32_t low = 0;
+                        if (end - p < 7 || p[1] != '\\' || p[2] != 'u' || !read_hex4(p + 3, end, low) ||
+                            low < 0xDC00 || low > 0xDFFF)
+                        {
+                            return false;
+                        }
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        p += 6;
+                    }
+                    append_utf8(code, out);
+                    break;
+                }
+                default:
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool to_number(const Value &value, double &number)
+        {
+            char buffer[64];
+            const size_t length = static_cast<size_t>(value.end - value.begin);
+            if (value.kind != Kind::Number || length >= sizeof(buffer))
+            {
+                return false;
+            }
+            std::memcpy(buffer, value.begin, length);
+            buffer[length] = '\0';
+            char *parsed = nullptr;
+            number = std::strtod(buffer, &parsed);
+            return parsed == buffer + length;
+        }
+    } // namespace json_scan
+
+} // namespace zmq_simple
@@ -0,0 +1,53 @@
+#ifndef ZMQ_SIMPLE_JSON_SCAN_HPP
+#define ZMQ_SIMPLE_JSON_SCAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace zmq_simple
+{
+    // 直接在 JSON 文本上定位字段，不构建 DOM、不分配内存。
+    // 只做定位所需的最少校验，不保证整个文档合法
+    namespace json_scan
+    {
+        enum class Kind
+        {
+            String, // 不含引号的原始内容，可能含转义
+            Number,
+            True,
+            False,
+            Null,
+            Object,
+            Array,
+        };
+
+        struct Value
+        {
+            Kind kind;
+            const char *begin;
+            const char *end;
+        };
+
+        // 把 JSON Pointer ("/a/b/0") 拆分为已反转义 (~0 ~1) 的 token，格式错误返回 false
+        bool split_pointer(const std::string &pointer, std::vector<std::string> &tokens);
+
+        // 数组下标 token: 十进制，不允许前导 0
+        bool parse_index(const std::string &token, size_t &index);
+
+        // 按 token 逐级查找，找不到或遇到非法内容返回 false
+        bool find(const char *begin, const char *end, const std::vector<std::string> &tokens, Value &value);
+
+        // 从 begin 处读取一个值 (跳过前导空白)，成功时 next 指向值之后
+        bool read_value(const char *begin, const char *end, Value &value, const char *&next);
+
+        // 还原字符串中的转义序列，\uXXXX 转为 UTF-8
+        bool unescape(const char *begin, const char *end, std::string &out);
+
+        bool to_number(const Value &value, double &number);
+    } // namespace json_scan
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_JSON_SCAN_HPP
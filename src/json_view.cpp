@@ -0,0 +1,457 @@
+#include "../include/zmq_simple_view.hpp"
+#include "json_index.hpp"
+#include "json_scan.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace zmq_simple
+{
+    namespace
+    {
+        const size_t kNone = static_cast<size_t>(-1);
+
+        inline bool is_space(char c)
+        {
+            return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+        }
+
+        bool is_number_char(char c)
+        {
+            return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+        }
+
+        // strtod 等需要以 0 结尾的字符串
+        bool copy_number(const JsonView::Value &value, char (&buffer)[64])
+        {
+            if (value.kind != JsonView::Kind::Number || value.size >= sizeof(buffer))
+            {
+                return false;
+            }
+            std::memcpy(buffer, value.data, value.size);
+            buffer[value.size] = '\0';
+            return true;
+        }
+    } // namespace
+
+    bool JsonView::Value::is_integer() const
+    {
+        if (kind != Kind::Number)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (data[i] == '.' || data[i] == 'e' || data[i] == 'E')
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool JsonView::Value::to_double(double &value) const
+    {
+        char buffer[64];
+        if (!copy_number(*this, buffer))
+        {
+            return false;
+        }
+        char *end = nullptr;
+        value = std::strtod(buffer, &end);
+        return end == buffer + size;
+    }
+
+    bool JsonView::Value::to_int(int64_t &value) const
+    {
+        char buffer[64];
+        if (!copy_number(*this, buffer))
+        {
+            return false;
+        }
+        char *end = nullptr;
+        errno = 0;
+        value = std::strtoll(buffer, &end, 10);
+        return end == buffer + size && errno == 0;
+    }
+
+    bool JsonView::Value::to_uint(uint64_t &value) const
+    {
+        char buffer[64];
+        if (!copy_number(*this, buffer) || buffer[0] == '-')
+        {
+            return false;
+        }
+        char *end = nullptr;
+        errno = 0;
+        value = std::strtoull(buffer, &end, 10);
+        return end == buffer + size && errno == 0;
+    }
+
+    bool JsonView::Value::to_bool(bool &value) const
+    {
+        if (kind != Kind::True && kind != Kind::False)
+        {
+            return false;
+        }
+        value = kind == Kind::True;
+        return true;
+    }
+
+    bool JsonView::Value::has_escapes() const
+    {
+        return kind == Kind::String && std::memchr(data, '\\', size) != nullptr;
+    }
+
+    bool JsonView::Value::to_string(std::string &value) const
+    {
+        if (kind != Kind::String)
+        {
+            return false;
+        }
+        if (!has_escapes())
+        {
+            value.assign(data, size);
+            return true;
+        }
+        return json_scan::unescape(data, data + size, value);
+    }
+
+    JsonView::JsonView()
+        : data_(nullptr), size_(0), count_(0), valid_(false)
+    {
+    }
+
+    JsonView::JsonView(const uint8_t *data, size_t size)
+        : data_(nullptr), size_(0), count_(0), valid_(false)
+    {
+        reset(data, size);
+    }
+
+    JsonView::JsonView(const Message &message)
+        : data_(nullptr), size_(0), count_(0), valid_(false)
+    {
+        reset(message.data(), message.size());
+    }
+
+    bool JsonView::reset(const uint8_t *data, size_t size)
+    {
+        data_ = reinterpret_cast<const char *>(data);
+        size_ = size;
+        // 索引空间只增不减，同一个视图重复使用时不再分配
+        const size_t capacity = json_index::capacity_for(size);
+        if (index_.size() < capacity)
+        {
+            index_.resize(capacity);
+        }
+        valid_ = json_index::build(data_, size_, index_.data(), count_);
+        if (valid_)
+        {
+            link_brackets();
+        }
+        return valid_;
+    }
+
+    // 一次遍历记录每个开括号对应的闭括号位置，之后跳过容器为 O(1)
+    void JsonView::link_brackets()
+    {
+        if (close_.size() < count_)
+        {
+            close_.resize(count_);
+        }
+        stack_.clear();
+        for (size_t i = 0; i < count_; ++i)
+        {
+            switch (data_[index_[i]])
+            {
+            case '{':
+            case '[':
+                close_[i] = kNoClose;
+                stack_.push_back(static_cast<uint32_t>(i));
+                break;
+            case '}':
+            case ']':
+                if (!stack_.empty())
+                {
+                    close_[stack_.back()] = static_cast<uint32_t>(i);
+                    stack_.pop_back();
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    bool JsonView::root(Value &value) const
+    {
+        size_t next = 0;
+        return valid_ && value_from(data_, 0, value, next);
+    }
+
+    // p 为值的起始位置 (可含前导空白)，entry 为 p 之后的第一个结构字符
+    bool JsonView::value_from(const char *p, size_t entry, Value &value, size_t &next) const
+    {
+        const char *end = data_ + size_;
+        while (p < end && is_space(*p))
+        {
+            ++p;
+        }
+        if (p == end)
+        {
+            return false;
+        }
+
+        if (entry < count_ && data_ + index_[entry] == p)
+        {
+            switch (*p)
+            {
+            case '"':
+                if (entry + 1 >= count_)
+                {
+                    return false;
+                }
+                value.kind = Kind::String;
+                value.data = p + 1;
+                value.size = index_[entry + 1] - index_[entry] - 1;
+                value.entry = entry;
+                next = entry + 2;
+                return true;
+            case '{':
+            case '[':
+            {
+                const size_t close = matching_close(entry);
+                if (close == kNone)
+                {
+                    return false;
+                }
+                value.kind = *p == '{' ? Kind::Object : Kind::Array;
+                value.data = p;
+                value.size = index_[close] - index_[entry] + 1;
+                value.entry = entry;
+                next = close + 1;
+                return true;
+            }
+            default:
+                return false; // 缺少值
+            }
+        }
+
+        // 数字和字面量不在索引中，范围到下一个结构字符为止
+        const char *limit = entry < count_ ? data_ + index_[entry] : end;
+        while (limit > p && is_space(limit[-1]))
+        {
+            --limit;
+        }
+        const size_t size = static_cast<size_t>(limit - p);
+        value.data = p;
+        value.size = size;
+        value.entry = entry;
+        next = entry;
+
+        if (size == 4 && std::memcmp(p, "true", 4) == 0)
+        {
+            value.kind = Kind::True;
+            return true;
+        }
+        if (size == 5 && std::memcmp(p, "false", 5) == 0)
+        {
+            value.kind = Kind::False;
+            return true;
+        }
+        if (size == 4 && std::memcmp(p, "null", 4) == 0)
+        {
+            value.kind = Kind::Null;
+            return true;
+        }
+        if (size == 0)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (!is_number_char(p[i]))
+            {
+                return false;
+            }
+        }
+        value.kind = Kind::Number;
+        return true;
+    }
+
+    size_t JsonView::matching_close(size_t entry) const
+    {
+        return close_[entry] == kNoClose ? kNone : close_[entry];
+    }
+
+    bool JsonView::next_member(const Value &object, size_t &cursor, Value &key, Value &value) const
+    {
+        if (object.kind != Kind::Object)
+        {
+            return false;
+        }
+
+        size_t k = cursor;
+        if (cursor == 0)
+        {
+            k = object.entry + 1;
+        }
+        else
+        {
+            if (k >= count_ || data_[index_[k]] != ',')
+            {
+                return false; // '}' 或结构错误
+            }
+            ++k;
+        }
+
+        if (k + 2 >= count_ || data_[index_[k]] != '"' || data_[index_[k + 2]] != ':')
+        {
+            return false; // 包括空对象
+        }
+        key.kind = Kind::String;
+        key.data = data_ + index_[k] + 1;
+        key.size = index_[k + 1] - index_[k] - 1;
+        key.entry = k;
+
+        size_t next = 0;
+        if (!value_from(data_ + index_[k + 2] + 1, k + 3, value, next))
+        {
+            return false;
+        }
+        cursor = next;
+        return true;
+    }
+
+    bool JsonView::next_element(const Value &array, size_t &cursor, Value &value) const
+    {
+        if (array.kind != Kind::Array)
+        {
+            return false;
+        }
+
+        size_t k = 0;
+        if (cursor == 0)
+        {
+            k = array.entry;
+        }
+        else
+        {
+            k = cursor;
+            if (k >= count_ || data_[index_[k]] != ',')
+            {
+                return false;
+            }
+        }
+
+        const char *p = data_ + index_[k] + 1;
+        if (cursor == 0 && k + 1 < count_ && data_[index_[k + 1]] == ']')
+        {
+            // 空数组: '[' 与 ']' 之间只有空白
+            const char *q = p;
+            while (is_space(*q))
+            {
+                ++q;
+            }
+            if (q == data_ + index_[k + 1])
+            {
+                return false;
+            }
+        }
+
+        size_t next = 0;
+        if (!value_from(p, k + 1, value, next))
+        {
+            return false;
+        }
+        cursor = next;
+        return true;
+    }
+
+    bool JsonView::at_end(const Value &container, size_t cursor) const
+    {
+        if (container.kind != Kind::Object && container.kind != Kind::Array)
+        {
+            return false;
+        }
+        // 未取到任何成员时，cursor 仍为 0，检查是否为空容器 (括号之间只有空白)
+        if (cursor == 0)
+        {
+            for (const char *p = container.data + 1; p < container.data + container.size - 1; ++p)
+            {
+                if (!is_space(*p))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        return cursor < count_ && data_ + index_[cursor] == container.data + container.size - 1;
+    }
+
+    bool JsonView::find(const Value &object, const char *key, size_t key_size, Value &value) const
+    {
+        size_t cursor = 0;
+        Value name;
+        std::string unescaped;
+        while (next_member(object, cursor, name, value))
+        {
+            if (!name.has_escapes())
+            {
+                if (name.size == key_size && std::memcmp(name.data, key, key_size) == 0)
+                {
+                    return true;
+                }
+            }
+            else if (name.to_string(unescaped) && unescaped.size() == key_size &&
+                     std::memcmp(unescaped.data(), key, key_size) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool JsonView::find(const std::string &pointer, Value &value) const
+    {
+        std::vector<std::string> tokens;
+        if (!json_scan::split_pointer(pointer, tokens) || !root(value))
+        {
+            return false;
+        }
+
+        for (const std::string &token : tokens)
+        {
+            const Value parent = value;
+            if (parent.kind == Kind::Object)
+            {
+                if (!find(parent, token.data(), token.size(), value))
+                {
+                    return false;
+                }
+            }
+            else if (parent.kind == Kind::Array)
+            {
+                size_t position = 0;
+                if (!json_scan::parse_index(token, position))
+                {
+                    return false;
+                }
+                size_t cursor = 0;
+                for (size_t i = 0; i <= position; ++i)
+                {
+                    if (!next_element(parent, cursor, value))
+                    {
+                        return false;
+                    }
+                }
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace zmq_simple
@@ -0,0 +1,303 @@
+#include "lz4_block.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace zmq_simple
+{
+    namespace lz4
+    {
+        namespace
+        {
+            const size_t kMinMatch = 4;
+            const size_t kLastLiterals = 5; // 块末尾至少保留 5 字节字面量
+            const size_t kMatchFindLimit = 12;
+            const size_t kMaxOffset = 65535;
+            const unsigned kHashLog = 12;
+            const size_t kTableSize = size_t(1) << kHashLog;
+
+            inline uint32_t read32(const uint8_t *p)
+            {
+                uint32_t v;
+                std::memcpy(&v, p, sizeof(v));
+                return v;
+            }
+
+            inline uint32_t hash4(uint32_t v)
+            {
+                return (v * 2654435761U) >> (32 - kHashLog);
+            }
+
+            inline uint8_t *write_length(uint8_t *op, size_t len)
+            {
+                while (len >= 255)
+                {
+                    *op++ = 255;
+                    len -= 255;
+                }
+                *op++ = static_cast<uint8_t>(len);
+                return op;
+            }
+
+            // 压缩 base[start, end)，base[0, start) 为字典前缀
+            // table 中的旧条目只作为候选，命中前都会比较实际字节，因此无需清零
+            size_t compress_range(const uint8_t *base, size_t start, size_t end,
+                                  uint8_t *dst, size_t capacity, uint32_t *table)
+            {
+                uint8_t *op = dst;
+                uint8_t *const oend = dst + capacity;
+
+                size_t anchor = start;
+                size_t ip = start;
+
+                if (end - start >= kMatchFindLimit + 1)
+                {
+                    const size_t match_limit = end - kMatchFindLimit;
+                    const size_t extend_limit = end - kLastLiterals;
+
+                    while (ip <= match_limit)
+                    {
+                        const uint32_t seq = read32(base + ip);
+                        const uint32_t h = hash4(seq);
+                        const size_t ref = table[h];
+                        table[h] = static_cast<uint32_t>(ip);
+
+                        if (ref >= ip || ip - ref > kMaxOffset || read32(base + ref) != seq)
+                        {
+                            // 长时间找不到匹配时加大步长
+                            ip += 1 + ((ip - anchor) >> 6);
+                            continue;
+                        }
+
+                        size_t len = kMinMatch;
+                        while (ip + len < extend_limit && base[ref + len] == base[ip + len])
+                        {
+                            ++len;
+                        }
+
+                        const size_t lit = ip - anchor;
+                        if (op + 1 + lit / 255 + 1 + lit + 2 + (len - kMinMatch) / 255 + 1 > oend)
+                        {
+                            return 0;
+                        }
+
+                        uint8_t *token = op++;
+                        *token = 0;
+                        if (lit >= 15)
+                        {
+                            *token = 15 << 4;
+                            op = write_length(op, lit - 15);
+                        }
+                        else
+                        {
+                            *token = static_cast<uint8_t>(lit << 4);
+                        }
+                        std::memcpy(op, base + anchor, lit);
+                        op += lit;
+
+                        const size_t offset = ip - ref;
+                        *op++ = static_cast<uint8_t>(offset & 0xFF);
+                        *op++ = static_cast<uint8_t>(offset >> 8);
+
+                        const size_t mlen = len - kMinMatch;
+                        if (mlen >= 15)
+                        {
+                            *token |= 15;
+                            op = write_length(op, mlen - 15);
+                        }
+                        else
+                        {
+                            *token |= static_cast<uint8_t>(mlen);
+                        }
+
+                        ip += len;
+                        anchor = ip;
+                        if (ip - 2 >= start && ip <= match_limit)
+                        {
+                            table[hash4(read32(base + ip - 2))] = static_cast<uint32_t>(ip - 2);
+                        }
+                    }
+                }
+
+                // 最后一段字面量
+                const size_t lit = end - anchor;
+                if (op + 1 + lit / 255 + 1 + lit > oend)
+                {
+                    return 0;
+                }
+                if (lit >= 15)
+                {
+                    *op++ = 15 << 4;
+                    op = write_length(op, lit - 15);
+                }
+                else
+                {
+                    *op++ = static_cast<uint8_t>(lit << 4);
+                }
+                std::memcpy(op, base + anchor, lit);
+                op += lit;
+
+                return static_cast<size_t>(op - dst);
+            }
+        } // namespace
+
+        size_t compress_bound(size_t size)
+        {
+            return size + size / 255 + 16;
+        }
+
+        size_t compress(const uint8_t *src, size_t size,
+                        uint8_t *dst, size_t capacity,
+                        const uint8_t *dict, size_t dict_size)
+        {
+            thread_local std::vector<uint32_t> table(kTableSize, 0);
+
+            if (dict == nullptr || dict_size == 0)
+            {
+                return compress_range(src, 0, size, dst, capacity, table.data());
+            }
+
+            if (dict_size > kMaxDictionarySize)
+            {
+                dict += dict_size - kMaxDictionarySize;
+                dict_size = kMaxDictionarySize;
+            }
+
+            // 字典的哈希表只在字典变化时重建，之后每次复制一份使用
+            thread_local std::vector<uint32_t> dict_table(kTableSize, 0);
+            thread_local std::vector<uint8_t> window;
+            thread_local const uint8_t *cached_dict = nullptr;
+            thread_local size_t cached_size = 0;
+
+            if (cached_dict != dict || cached_size != dict_size ||
+                window.size() < dict_size || std::memcmp(window.data(), dict, dict_size) != 0)
+            {
+                window.assign(dict, dict + dict_size);
+                std::fill(dict_table.begin(), dict_table.end(), 0);
+                for (size_t i = 0; i + kMinMatch <= dict_size; ++i)
+                {
+                    dict_table[hash4(read32(dict + i))] = static_cast<uint32_t>(i);
+                }
+                cached_dict = dict;
+                cached_size = dict_size;
+            }
+
+            // 字典与数据拼成连续窗口，匹配可以回溯到字典中
+            window.resize(dict_size + size);
+            std::memcpy(window.data() + dict_size, src, size);
+            std::memcpy(table.data(), dict_table.data(), kTableSize * sizeof(uint32_t));
+            return compress_range(window.data(), dict_size, dict_size + size, dst, capacity, table.data());
+        }
+
+        bool decompress(const uint8_t *src, size_t size,
+                        uint8_t *dst, size_t raw_size,
+                        const uint8_t *dict, size_t dict_size)
+        {
+            const uint8_t *ip = src;
+            const uint8_t *const iend = src + size;
+            size_t op = 0;
+
+            if (dict == nullptr)
+            {
+                dict_size = 0;
+            }
+
+            while (ip < iend)
+            {
+                const uint8_t token = *ip++;
+
+                size_t lit = token >> 4;
+                if (lit == 15)
+                {
+                    uint8_t b;
+                    do
+                    {
+                        if (ip >= iend)
+                        {
+                            return false;
+                        }
+                        b = *ip++;
+                        lit += b;
+                    } while (b == 255);
+                }
+                if (lit > static_cast<size_t>(iend - ip) || lit > raw_size - op)
+                {
+                    return false;
+                }
+                std::memcpy(dst + op, ip, lit);
+                ip += lit;
+                op += lit;
+
+                if (ip == iend)
+                {
+                    break;
+                }
+
+                if (iend - ip < 2)
+                {
+                    return false;
+                }
+                const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+                ip += 2;
+                if (offset == 0 || offset > op + dict_size)
+                {
+                    return false;
+                }
+
+                size_t mlen = token & 15;
+                if (mlen == 15)
+                {
+                    uint8_t b;
+                    do
+                    {
+                        if (ip >= iend)
+                        {
+                            return false;
+                        }
+                        b = *ip++;
+                        mlen += b;
+                    } while (b == 255);
+                }
+                mlen += kMinMatch;
+                if (mlen > raw_size - op)
+                {
+                    return false;
+                }
+
+                if (offset > op)
+                {
+                    // 匹配起点落在字典中
+                    size_t back = offset - op;
+                    const uint8_t *from = dict + dict_size - back;
+                    const size_t from_dict = back < mlen ? back : mlen;
+                    std::memcpy(dst + op, from, from_dict);
+                    op += from_dict;
+                    mlen -= from_dict;
+                    if (mlen == 0)
+                    {
+                        continue;
+                    }
+                }
+
+                const uint8_t *match = dst + op - offset;
+                if (offset >= mlen)
+                {
+                    std::memcpy(dst + op, match, mlen);
+                    op += mlen;
+                }
+                else
+                {
+                    // 重叠复制必须逐字节进行
+                    for (size_t i = 0; i < mlen; ++i)
+                    {
+                        dst[op + i] = match[i];
+                    }
+                    op += mlen;
+                }
+            }
+
+            return op == raw_size;
+        }
+    } // namespace lz4
+
+} // namespace zmq_simple
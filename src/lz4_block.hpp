@@ -0,0 +1,30 @@
+#ifndef ZMQ_SIMPLE_LZ4_BLOCK_HPP
+#define ZMQ_SIMPLE_LZ4_BLOCK_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace zmq_simple
+{
+    // LZ4 block 格式编解码 (与 lz4 官方 block 格式兼容，不含 frame 头)
+    // 字典以"前缀窗口"的方式参与匹配，最多使用字典末尾 64KB
+    namespace lz4
+    {
+        const size_t kMaxDictionarySize = 64 * 1024;
+
+        size_t compress_bound(size_t size);
+
+        // 返回压缩后长度，输出空间不足时返回 0
+        size_t compress(const uint8_t *src, size_t size,
+                        uint8_t *dst, size_t capacity,
+                        const uint8_t *dict = nullptr, size_t dict_size = 0);
+
+        // 解压到长度恰好为 raw_size 的缓冲区，成功返回 true
+        bool decompress(const uint8_t *src, size_t size,
+                        uint8_t *dst, size_t raw_size,
+                        const uint8_t *dict = nullptr, size_t dict_size = 0);
+    } // namespace lz4
+
+} // namespace zmq_simple
+
+#endif // ZMQ_SIMPLE_LZ4_BLOCK_HPP
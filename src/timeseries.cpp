@@ -0,0 +1,459 @@
+#include "../include/zmq_simple_timeseries.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace zmq_simple
+{
+    namespace
+    {
+        // 块格式: [版本][序列数 varint]，每个序列为
+        // [名字长度 varint][名字][样本数 varint][比特流字节数 varint][比特流]
+        const uint8_t kBlockVersion = 1;
+
+        inline uint64_t low_bits(uint64_t value, unsigned n)
+        {
+            return n >= 64 ? value : value & ((uint64_t(1) << n) - 1);
+        }
+
+        inline unsigned leading_zeros(uint64_t v)
+        {
+            return v == 0 ? 64 : static_cast<unsigned>(__builtin_clzll(v));
+        }
+
+        inline unsigned trailing_zeros(uint64_t v)
+        {
+            return v == 0 ? 64 : static_cast<unsigned>(__builtin_ctzll(v));
+        }
+
+        inline uint64_t double_bits(double value)
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        inline double bits_double(uint64_t bits)
+        {
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        void put_varint(std::vector<uint8_t> &out, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        bool get_varint(const uint8_t *&p, const uint8_t *end, uint64_t &value)
+        {
+            value = 0;
+            for (unsigned shift = 0; shift < 64 && p < end; shift += 7)
+            {
+                const uint8_t byte = *p++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // 高位在前的比特流
+        class BitWriter
+        {
+        public:
+            explicit BitWriter(std::vector<uint8_t> &out) : out_(out), acc_(0), bits_(0) {}
+
+            void write(uint64_t value, unsigned n)
+            {
+                if (n > 32)
+                {
+                    write(value >> 32, n - 32);
+                    n = 32;
+                }
+                // acc_ 中至多 7 个待写比特，加 32 位不会溢出
+                acc_ = (acc_ << n) | low_bits(value, n);
+                bits_ += n;
+                while (bits_ >= 8)
+                {
+                    bits_ -= 8;
+                    out_.push_back(static_cast<uint8_t>(acc_ >> bits_));
+                }
+                acc_ = low_bits(acc_, bits_);
+            }
+
+            void finish()
+            {
+                if (bits_ > 0)
+                {
+                    out_.push_back(static_cast<uint8_t>(acc_ << (8 - bits_)));
+                    acc_ = 0;
+                    bits_ = 0;
+                }
+            }
+
+        private:
+            std::vector<uint8_t> &out_;
+            uint64_t acc_;
+            unsigned bits_;
+        };
+
+        class BitReader
+        {
+        public:
+            BitReader(const uint8_t *data, size_t size) : p_(data), end_(data + size), acc_(0), bits_(0) {}
+
+            bool read(unsigned n, uint64_t &value)
+            {
+                if (n > 32)
+                {
+                    uint64_t high = 0;
+                    if (!read(n - 32, high) || !read(32, value))
+                    {
+                        return false;
+                    }
+                    value |= high << 32;
+                    return true;
+                }
+                while (bits_ < n)
+                {
+                    if (p_ == end_)
+                    {
+                        return false;
+                    }
+                    acc_ = (acc_ << 8) | *p_++;
+                    bits_ += 8;
+                }
+                bits_ -= n;
+                value = low_bits(acc_ >> bits_, n);
+                acc_ = low_bits(acc_, bits_);
+                return true;
+            }
+
+            // 连续的 1 的个数，遇到 0 或达到 limit 为止
+            bool read_prefix(unsigned limit, unsigned &ones)
+            {
+                ones = 0;
+                uint64_t bit = 0;
+                while (ones < limit)
+                {
+                    if (!read(1, bit))
+                    {
+                        return false;
+                    }
+                    if (bit == 0)
+                    {
+                        break;
+                    }
+                    ++ones;
+                }
+                return true;
+            }
+
+        private:
+            const uint8_t *p_;
+            const uint8_t *end_;
+            uint64_t acc_;
+            unsigned bits_;
+        };
+
+        // 二阶差分按范围分档: 0 / 7 / 9 / 12 位，其余写满 64 位
+        struct Bucket
+        {
+            unsigned bits;
+            int64_t bias;
+        };
+        const Bucket kBuckets[] = {{7, 63}, {9, 255}, {12, 2047}};
+
+        void write_timestamp(BitWriter &writer, int64_t dod)
+        {
+            if (dod == 0)
+            {
+                writer.write(0, 1);
+                return;
+            }
+            for (unsigned i = 0; i < 3; ++i)
+            {
+                const int64_t bias = kBuckets[i].bias;
+                if (dod >= -bias && dod <= bias + 1)
+                {
+                    // 前缀 i+1 个 1 后接 0
+                    writer.write((uint64_t(1) << (i + 2)) - 2, i + 2);
+                    writer.write(static_cast<uint64_t>(dod + bias), kBuckets[i].bits);
+                    return;
+                }
+            }
+            writer.write(0xF, 4);
+            writer.write(static_cast<uint64_t>(dod), 64);
+        }
+
+        bool read_timestamp(BitReader &reader, int64_t &dod)
+        {
+            unsigned ones = 0;
+            uint64_t value = 0;
+            if (!reader.read_prefix(4, ones))
+            {
+                return false;
+            }
+            if (ones == 0)
+            {
+                dod = 0;
+                return true;
+            }
+            if (ones == 4)
+            {
+                if (!reader.read(64, value))
+                {
+                    return false;
+                }
+                dod = static_cast<int64_t>(value);
+                return true;
+            }
+            const Bucket &bucket = kBuckets[ones - 1];
+            if (!reader.read(bucket.bits, value))
+            {
+                return false;
+            }
+            dod = static_cast<int64_t>(value) - bucket.bias;
+            return true;
+        }
+
+        // 与前一个值异或: 相同写 0；有效位落在上一个窗口内时只写窗口，否则写新的窗口
+        struct XorState
+        {
+            uint64_t previous = 0;
+            unsigned leading = 0;
+            unsigned trailing = 0;
+            bool window = false;
+        };
+
+        void write_value(BitWriter &writer, XorState &state, uint64_t bits)
+        {
+            const uint64_t x = bits ^ state.previous;
+            state.previous = bits;
+            if (x == 0)
+            {
+                writer.write(0, 1);
+                return;
+            }
+
+            const unsigned leading = std::min(leading_zeros(x), 31u);
+            const unsigned trailing = trailing_zeros(x);
+            if (state.window && leading >= state.leading && trailing >= state.trailing)
+            {
+                writer.write(2, 2);
+                writer.write(x >> state.trailing, 64 - state.leading - state.trailing);
+                return;
+            }
+
+            const unsigned significant = 64 - leading - trailing;
+            writer.write(3, 2);
+            writer.write(leading, 5);
+            writer.write(significant & 63, 6); // 64 记为 0
+            writer.write(x >> trailing, significant);
+            state.leading = leading;
+            state.trailing = trailing;
+            state.window = true;
+        }
+
+        bool read_value(BitReader &reader, XorState &state, uint64_t &bits)
+        {
+            uint64_t flag = 0;
+            if (!reader.read(1, flag))
+            {
+                return false;
+            }
+            if (flag == 0)
+            {
+                bits = state.previous;
+                return true;
+            }
+            if (!reader.read(1, flag))
+            {
+                return false;
+            }
+
+            if (flag == 1)
+            {
+                uint64_t leading = 0;
+                uint64_t significant = 0;
+                if (!reader.read(5, leading) || !reader.read(6, significant))
+                {
+                    return false;
+                }
+                if (significant == 0)
+                {
+                    significant = 64;
+                }
+                if (leading + significant > 64)
+                {
+                    return false;
+                }
+                state.leading = static_cast<unsigned>(leading);
+                state.trailing = static_cast<unsigned>(64 - leading - significant);
+                state.window = true;
+            }
+            else if (!state.window)
+            {
+                return false;
+            }
+
+            uint64_t x = 0;
+            if (!reader.read(64 - state.leading - state.trailing, x))
+            {
+                return false;
+            }
+            state.previous ^= x << state.trailing;
+            bits = state.previous;
+            return true;
+        }
+
+        void encode_series(const TimeSeries &series, size_t count, std::vector<uint8_t> &out)
+        {
+            BitWriter writer(out);
+            XorState values;
+            uint64_t previous = 0;
+            uint64_t delta = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                // 按无符号运算，溢出时回绕，解码端同样回绕即可还原
+                const uint64_t timestamp = static_cast<uint64_t>(series.timestamps[i]);
+                if (i == 0)
+                {
+                    writer.write(timestamp, 64);
+                    writer.write(double_bits(series.values[i]), 64);
+                    values.previous = double_bits(series.values[i]);
+                }
+                else
+                {
+                    const uint64_t current = timestamp - previous;
+                    write_timestamp(writer, static_cast<int64_t>(current - delta));
+                    write_value(writer, values, double_bits(series.values[i]));
+                    delta = current;
+                }
+                previous = timestamp;
+            }
+            writer.finish();
+        }
+
+        bool decode_series(const uint8_t *data, size_t size, size_t count, TimeSeries &series)
+        {
+            // 首个样本 16 字节，之后每个样本至少 2 比特
+            if (count > 0 && (size < 16 || count - 1 > (size - 16) * 4))
+            {
+                return false;
+            }
+            series.timestamps.resize(count);
+            series.values.resize(count);
+
+            BitReader reader(data, size);
+            XorState values;
+            uint64_t previous = 0;
+            uint64_t delta = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint64_t bits = 0;
+                if (i == 0)
+                {
+                    if (!reader.read(64, previous) || !reader.read(64, bits))
+                    {
+                        return false;
+                    }
+                    values.previous = bits;
+                }
+                else
+                {
+                    int64_t dod = 0;
+                    if (!read_timestamp(reader, dod) || !read_value(reader, values, bits))
+                    {
+                        return false;
+                    }
+                    delta += static_cast<uint64_t>(dod);
+                    previous += delta;
+                }
+                series.timestamps[i] = static_cast<int64_t>(previous);
+                series.values[i] = bits_double(bits);
+            }
+            return true;
+        }
+    } // namespace
+
+    void encode_time_series(const std::vector<TimeSeries> &series, std::vector<uint8_t> &out)
+    {
+        out.clear();
+        out.push_back(kBlockVersion);
+
+        size_t present = 0;
+        for (const TimeSeries &s : series)
+        {
+            present += std::min(s.timestamps.size(), s.values.size()) != 0;
+        }
+        put_varint(out, present);
+
+        std::vector<uint8_t> bits;
+        for (const TimeSeries &s : series)
+        {
+            const size_t count = std::min(s.timestamps.size(), s.values.size());
+            if (count == 0)
+            {
+                continue; // 本块中没有样本的序列不写入
+            }
+            put_varint(out, s.name.size());
+            out.insert(out.end(), s.name.begin(), s.name.end());
+            put_varint(out, count);
+
+            bits.clear();
+            encode_series(s, count, bits);
+            put_varint(out, bits.size());
+            out.insert(out.end(), bits.begin(), bits.end());
+        }
+    }
+
+    bool decode_time_series(const uint8_t *data, size_t size, std::vector<TimeSeries> &series)
+    {
+        const uint8_t *p = data;
+        const uint8_t *const end = data + size;
+        uint64_t count = 0;
+        if (size == 0 || *p++ != kBlockVersion || !get_varint(p, end, count) ||
+            count > static_cast<uint64_t>(end - p))
+        {
+            return false;
+        }
+
+        series.resize(static_cast<size_t>(count));
+        for (TimeSeries &s : series)
+        {
+            uint64_t name_size = 0;
+            uint64_t samples = 0;
+            uint64_t bits_size = 0;
+            if (!get_varint(p, end, name_size) || name_size > static_cast<uint64_t>(end - p))
+            {
+                return false;
+            }
+            s.name.assign(reinterpret_cast<const char *>(p), static_cast<size_t>(name_size));
+            p += name_size;
+
+            if (!get_varint(p, end, samples) || !get_varint(p, end, bits_size) ||
+                bits_size > static_cast<uint64_t>(end - p) || samples > SIZE_MAX ||
+                !decode_series(p, static_cast<size_t>(bits_size), static_cast<size_t>(samples), s))
+            {
+                return false;
+            }
+            p += bits_size;
+        }
+        return p == end;
+    }
+
+    bool decode_time_series(const Message &message, std::vector<TimeSeries> &series)
+    {
+        return message.content_type() == ContentType::TimeSeries &&
+               decode_time_series(message.data(), message.size(), series);
+    }
+
+} // namespace zmq_simple
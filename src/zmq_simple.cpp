@@ -1,5 +1,16 @@
 #include "../include/zmq_simple.hpp"
+#include "compression.hpp"
+#include "content_filter.hpp"
+#include "delta.hpp"
+#include "envelope.hpp"
+#include "fd_channel.hpp"
+#include "lz4_block.hpp"
 #include <zmq.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <set>
 #include <thread>
 #include <atomic>
 #include <cstring>
@@ -29,11 +40,45 @@ namespace zmq_simple
         return context_;
     }
 
+    namespace
+    {
+        // memfd 旁路套接字与 IPC 端点放在同一目录
+        std::string memfd_path(const std::string &endpoint)
+        {
+            return "/tmp/docker_share/" + endpoint + ".fd";
+        }
+
+        // 池化负载前的头部，保持负载 16 字节对齐
+        const size_t kPooledHeader = 16;
+
+        // zmq_msg_init_data 的释放回调，在 ZeroMQ 的 I/O 线程中执行。
+        // hint 持有 resource 的一份引用，发送途中更换或清除 resource 不影响归还
+        void release_pooled(void *data, void *hint)
+        {
+            std::shared_ptr<MemoryResource> *resource = static_cast<std::shared_ptr<MemoryResource> *>(hint);
+            uint8_t *block = static_cast<uint8_t *>(data) - kPooledHeader;
+            size_t size = 0;
+            std::memcpy(&size, block, sizeof(size));
+            (*resource)->deallocate(block, size);
+            delete resource;
+        }
+
+        // 小于该长度的零拷贝负载仍然复制，复制比登记释放回调更便宜
+        const size_t kSharedMinSize = 1024;
+
+        // publish_shared 的释放回调，在 ZeroMQ 的 I/O 线程中执行
+        void release_shared(void *, void *hint)
+        {
+            delete static_cast<std::shared_ptr<void> *>(hint);
+        }
+    } // namespace
+
     class Publisher::Impl
     {
     public:
         Impl(const std::string &endpoint, Transport transport)
-            : owns_context_(true)
+            : endpoint_(endpoint), transport_(transport), owns_context_(true), compress_(false), dict_id_(0),
+              control_(nullptr), stream_base_(random_stream_base()), stream_counter_(0)
         {
             context_ = zmq_ctx_new();
             socket_ = zmq_socket(context_, ZMQ_PUB);
@@ -47,7 +92,8 @@ namespace zmq_simple
         }
 
         Impl(const std::string &endpoint, Transport transport, void *shared_context)
-            : owns_context_(false), context_(shared_context)
+            : endpoint_(endpoint), transport_(transport), owns_context_(false), context_(shared_context),
+              compress_(false), dict_id_(0), control_(nullptr), stream_base_(random_stream_base()), stream_counter_(0)
         {
             socket_ = zmq_socket(context_, ZMQ_PUB);
 
@@ -61,6 +107,10 @@ namespace zmq_simple
 
         ~Impl()
         {
+            if (control_)
+            {
+                zmq_close(control_);
+            }
             if (socket_)
             {
                 zmq_close(socket_);
@@ -71,198 +121,486 @@ namespace zmq_simple
             }
         }
 
-        bool publish(const std::string &topic, const void *data, size_t size)
+        // metadata 随 envelope 发送 (见 Message::metadata)，带元数据的消息不做差分
+        bool publish(const std::string &topic, const void *data, size_t size, ContentType content_type,
+                     const std::string &metadata = std::string())
         {
-            // 先发送Topic
-            if (zmq_send(socket_, topic.c_str(), topic.size(), ZMQ_SNDMORE) == -1)
+            const uint8_t type = static_cast<uint8_t>(content_type);
+
+            if (delta_ && metadata.empty() && size >= delta_options_.min_size && size <= UINT32_MAX)
             {
-                return false;
+                return publish_delta(topic, static_cast<const uint8_t *>(data), size, type);
             }
 
-            // 再发送Data
-            if (zmq_send(socket_, data, size, 0) == -1)
+            if (fd_server_ && size >= memfd_threshold_)
+            {
+                envelope::MemfdRef ref = {0, size};
+                if (fd_server_->publish(topic, data, size, ref.token))
+                {
+                    envelope::Header header = envelope::make_header(envelope::FLAG_MEMFD, type);
+                    return send_message(topic, &header, &ref, sizeof(ref), metadata);
+                }
+                // 没有订阅端接收描述符或 memfd 创建失败时退回普通发送
+            }
+
+            size_t compressed = 0;
+            if (compress(data, size, compressed))
+            {
+                envelope::Header header = envelope::make_header(envelope::FLAG_COMPRESSED, type);
+                header.raw_size = static_cast<uint32_t>(size);
+                header.dict_id = dict_id_;
+                return send_message(topic, &header, scratch_.data(), compressed, metadata);
+            }
+
+            // 未标注类型且没有元数据的普通消息保持两帧格式
+            if (content_type != ContentType::Raw || !metadata.empty())
+            {
+                envelope::Header header = envelope::make_header(0, type);
+                header.raw_size = static_cast<uint32_t>(std::min<size_t>(size, UINT32_MAX));
+                return send_message(topic, &header, data, size, metadata);
+            }
+            return send_message(topic, nullptr, data, size);
+        }
+
+        bool publish_shared(const std::string &topic, const void *data, size_t size, std::shared_ptr<void> holder,
+                            ContentType content_type, const std::string &metadata)
+        {
+            // 差分、memfd 和压缩会生成新的负载，这些情况与小负载一样按普通方式发送
+            const size_t threshold = dict_id_ != 0 ? compression_.dictionary_min_size : compression_.min_size;
+            if (size < kSharedMinSize || (delta_ && metadata.empty() && size >= delta_options_.min_size) ||
+                (fd_server_ && size >= memfd_threshold_) || (compress_ && size >= threshold))
+            {
+                return publish(topic, data, size, content_type, metadata);
+            }
+
+            envelope::Header header = envelope::make_header(0, static_cast<uint8_t>(content_type));
+            header.raw_size = static_cast<uint32_t>(std::min<size_t>(size, UINT32_MAX));
+            const bool extended = content_type != ContentType::Raw || !metadata.empty();
+            if (!send_prefix(topic, extended ? &header : nullptr, metadata))
             {
                 return false;
             }
 
+            zmq_msg_t msg;
+            std::shared_ptr<void> *hint = new std::shared_ptr<void>(std::move(holder));
+            if (zmq_msg_init_data(&msg, const_cast<void *>(data), size, release_shared, hint) != 0)
+            {
+                delete hint;
+                return false;
+            }
+            if (zmq_msg_send(&msg, socket_, 0) == -1)
+            {
+                zmq_msg_close(&msg);
+                return false;
+            }
             return true;
         }
 
-    private:
-        std::string build_address(const std::string &endpoint, Transport transport)
+        void set_compression(const CompressionOptions &options)
         {
-            if (transport == Transport::IPC)
+            compression_ = options;
+            if (compression_.dictionary.size() > lz4::kMaxDictionarySize)
             {
-                return "ipc:///tmp/docker_share/" + endpoint + ".ipc";
+                compression_.dictionary.erase(compression_.dictionary.begin(),
+                                              compression_.dictionary.end() - lz4::kMaxDictionarySize);
             }
-            else
+            dict_id_ = dictionary_id(compression_.dictionary);
+            compress_ = true;
+        }
+
+        void disable_compression()
+        {
+            compress_ = false;
+        }
+
+        void enable_streaming(const StreamOptions &options)
+        {
+            stream_options_ = options;
+            if (stream_options_.chunk_size == 0)
             {
-                return "inproc://" + endpoint;
+                stream_options_.chunk_size = StreamOptions().chunk_size;
             }
+            open_control();
         }
 
-        bool owns_context_;
-        void *context_;
-        void *socket_;
-    };
-
-    Publisher::Publisher(const std::string &endpoint, Transport transport)
-        : pimpl_(std::make_unique<Impl>(endpoint, transport))
-    {
-    }
+        void set_memory_resource(std::shared_ptr<MemoryResource> resource, size_t min_size)
+        {
+            resource_ = std::move(resource);
+            pool_min_size_ = min_size;
+        }
 
-    Publisher::Publisher(const std::string &endpoint, Transport transport, Context &shared_context)
-        : pimpl_(std::make_unique<Impl>(endpoint, transport, shared_context.get_raw_context()))
-    {
-    }
+        void enable_delta(const DeltaOptions &options)
+        {
+            delta_options_ = options;
+            delta_options_.keyframe_interval = std::max<uint32_t>(1, delta_options_.keyframe_interval);
+            open_control();
+            delta_ = true;
+        }
 
-    Publisher::~Publisher() = default;
+        void enable_memfd(size_t threshold)
+        {
+            if (transport_ != Transport::IPC)
+            {
+                throw std::runtime_error("memfd payload handoff requires IPC transport");
+            }
+            memfd_threshold_ = std::max<size_t>(1, threshold);
+            if (!fd_server_)
+            {
+                fd_server_.reset(new fd_channel::Server(memfd_path(endpoint_)));
+            }
+        }
 
-    bool Publisher::publish(const std::string &topic, const std::string &data)
-    {
-        return pimpl_->publish(topic, data.c_str(), data.size());
-    }
+        size_t chunk_size() const
+        {
+            return stream_options_.chunk_size;
+        }
 
-    bool Publisher::publish(const std::string &topic, const void *data, size_t size)
-    {
-        return pimpl_->publish(topic, data, size);
-    }
+        uint64_t begin_stream()
+        {
+            if (control_ == nullptr)
+            {
+                enable_streaming(stream_options_);
+            }
+            const uint64_t id = stream_base_ + (++stream_counter_);
+            handle_control(0);
+            streams_[id] = 0;
+            return id;
+        }
 
-    class Subscriber::Impl
-    {
-    public:
-        Impl(const std::string &endpoint, Transport transport)
-            : running_(false), owns_context_(true)
+        bool send_chunk(const std::string &topic, uint64_t stream_id, const void *data, size_t size, bool last)
         {
-            context_ = zmq_ctx_new();
-            socket_ = zmq_socket(context_, ZMQ_SUB);
+            auto it = streams_.find(stream_id);
+            if (it == streams_.end())
+            {
+                return false;
+            }
 
-            const std::string addr = build_address(endpoint, transport);
+            const uint64_t sequence = it->second;
+            wait_for_credit(topic, stream_id, sequence);
 
-            if (zmq_connect(socket_, addr.c_str()) != 0)
+            envelope::Header header = envelope::make_header(
+                envelope::FLAG_STREAM_CHUNK | (last ? envelope::FLAG_STREAM_END : 0));
+            header.raw_size = static_cast<uint32_t>(size);
+            header.stream_id = stream_id;
+            header.sequence = sequence;
+            const bool ok = send_message(topic, &header, data, size);
+
+            it->second = sequence + 1;
+            if (last)
             {
-                throw std::runtime_error("Failed to connect subscriber: " + std::string(zmq_strerror(zmq_errno())));
+                streams_.erase(it);
+                for (auto &peer : peers_)
+                {
+                    peer.second.acked.erase(stream_id);
+                }
             }
+            return ok;
         }
 
-        Impl(const std::string &endpoint, Transport transport, void *shared_context)
-            : running_(false), owns_context_(false), context_(shared_context)
+    private:
+        struct Peer
         {
-            socket_ = zmq_socket(context_, ZMQ_SUB);
+            uint32_t window = 1;
+            bool alive = true;
+            std::chrono::steady_clock::time_point last_seen;
+            std::multiset<std::string> topics;   // 订阅端的 Topic 前缀
+            std::map<uint64_t, uint64_t> acked;  // 流 ID -> 已确认块数
+        };
 
-            std::string addr = build_address(endpoint, transport);
+        struct DeltaState
+        {
+            uint64_t version = 0;          // 已发送的版本号，0 表示尚未发送
+            uint32_t since_keyframe = 0;
+            bool keyframe_requested = false;
+            std::vector<uint8_t> last;     // 上一版本的负载
+        };
 
-            if (zmq_connect(socket_, addr.c_str()) != 0)
+        void open_control()
+        {
+            if (control_ != nullptr)
             {
-                throw std::runtime_error("Failed to connect subscriber: " + std::string(zmq_strerror(zmq_errno())));
+                return;
+            }
+
+            control_ = zmq_socket(context_, ZMQ_ROUTER);
+            const std::string addr = build_address(endpoint_ + "_ctl", transport_);
+            if (zmq_bind(control_, addr.c_str()) != 0)
+            {
+                const std::string error = zmq_strerror(zmq_errno());
+                zmq_close(control_);
+                control_ = nullptr;
+                throw std::runtime_error("Failed to bind control channel: " + error);
             }
         }
 
-        ~Impl()
+        // 压缩到 scratch_，没有收益或未开启压缩时返回 false
+        bool compress(const void *data, size_t size, size_t &compressed)
         {
-            stop_loop();
+            const size_t threshold = dict_id_ != 0 ? compression_.dictionary_min_size : compression_.min_size;
+            if (!compress_ || size < threshold || size > UINT32_MAX)
+            {
+                return false;
+            }
+            scratch_.resize(lz4::compress_bound(size));
+            compressed = lz4::compress(static_cast<const uint8_t *>(data), size,
+                                       scratch_.data(), scratch_.size(),
+                                       compression_.dictionary.data(), compression_.dictionary.size());
+            return compressed != 0 && compressed < size;
+        }
 
-            if (socket_)
+        // 版本号随每条消息递增，订阅端只在持有 sequence - 1 时应用差分
+        bool publish_delta(const std::string &topic, const uint8_t *data, size_t size, uint8_t type)
+        {
+            handle_control(0);
+            DeltaState &state = deltas_[topic];
+
+            bool keyframe = state.version == 0 || state.keyframe_requested ||
+                            state.since_keyframe + 1 >= delta_options_.keyframe_interval;
+            if (!keyframe)
             {
-                zmq_close(socket_);
+                delta::encode(state.last.data(), state.last.size(), data, size, delta_scratch_);
+                keyframe = delta_scratch_.size() >= size / 2; // 差分没有明显收益
             }
-            if (context_ && owns_context_)
+
+            envelope::Header header = envelope::make_header(
+                keyframe ? envelope::FLAG_KEYFRAME : envelope::FLAG_DELTA, type);
+            header.raw_size = static_cast<uint32_t>(size);
+            header.stream_id = stream_base_;
+            header.sequence = ++state.version;
+
+            bool ok = false;
+            size_t compressed = 0;
+            if (!keyframe)
             {
-                zmq_ctx_destroy(context_);
+                ok = send_message(topic, &header, delta_scratch_.data(), delta_scratch_.size());
+                ++state.since_keyframe;
+            }
+            else
+            {
+                if (compress(data, size, compressed))
+                {
+                    header.flags |= envelope::FLAG_COMPRESSED;
+                    header.dict_id = dict_id_;
+                    ok = send_message(topic, &header, scratch_.data(), compressed);
+                }
+                else
+                {
+                    ok = send_message(topic, &header, data, size);
+                }
+                state.since_keyframe = 0;
+                state.keyframe_requested = false;
             }
+            state.last.assign(data, data + size);
+            return ok;
         }
 
-        bool subscribe(const std::string &topic)
+        static uint64_t random_stream_base()
         {
-            return zmq_setsockopt(socket_, ZMQ_SUBSCRIBE, topic.c_str(), topic.size()) == 0;
+            std::random_device rd;
+            return (static_cast<uint64_t>(rd()) << 32) ^ (static_cast<uint64_t>(rd()) << 16);
         }
 
-        bool unsubscribe(const std::string &topic)
+        static bool matches(const Peer &peer, const std::string &topic)
         {
-            return zmq_setsockopt(socket_, ZMQ_UNSUBSCRIBE, topic.c_str(), topic.size()) == 0;
+            for (const std::string &prefix : peer.topics)
+            {
+                if (topic.compare(0, prefix.size(), prefix) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
         }
 
-        bool receive(std::string &topic, std::vector<uint8_t> &data, int timeout_ms)
+        // 处理订阅端发来的信用与订阅信息
+        void handle_control(int timeout_ms)
         {
-            if (timeout_ms >= 0)
+            zmq_pollitem_t item = {control_, 0, ZMQ_POLLIN, 0};
+            if (zmq_poll(&item, 1, timeout_ms) <= 0)
             {
-                zmq_setsockopt(socket_, ZMQ_RCVTIMEO, &timeout_ms, sizeof(timeout_ms));
+                return;
             }
 
-            // 接收Topic
-            zmq_msg_t topic_msg;
-            zmq_msg_init(&topic_msg);
-
-            int rc = zmq_msg_recv(&topic_msg, socket_, 0);
-            if (rc == -1)
+            char identity[256];
+            uint8_t buffer[sizeof(control::Packet) + 1024];
+            while (true)
             {
-                zmq_msg_close(&topic_msg);
-                if (zmq_errno() == EAGAIN)
+                const int id_size = zmq_recv(control_, identity, sizeof(identity), ZMQ_DONTWAIT);
+                if (id_size == -1)
                 {
-                    return false; // Timeout
+                    break;
+                }
+                const int size = zmq_recv(control_, buffer, sizeof(buffer), ZMQ_DONTWAIT);
+                if (size < static_cast<int>(sizeof(control::Packet)))
+                {
+                    continue;
                 }
-                return false;
-            }
 
-            topic.assign(static_cast<const char *>(zmq_msg_data(&topic_msg)), zmq_msg_size(&topic_msg));
-            zmq_msg_close(&topic_msg);
+                control::Packet packet;
+                std::memcpy(&packet, buffer, sizeof(packet));
+                const std::string key(identity, std::min<size_t>(id_size, sizeof(identity)));
 
-            // 接收Data
-            zmq_msg_t data_msg;
-            zmq_msg_init(&data_msg);
+                if (packet.type == control::BYE)
+                {
+                    peers_.erase(key);
+                    continue;
+                }
 
-            rc = zmq_msg_recv(&data_msg, socket_, 0);
-            if (rc == -1)
+                const size_t topic_size = std::min<size_t>(size, sizeof(buffer)) - sizeof(packet);
+                const std::string topic(reinterpret_cast<const char *>(buffer) + sizeof(packet), topic_size);
+                if (packet.type == control::KEYFRAME)
+                {
+                    // 下次发布匹配的 Topic 时发送完整版本
+                    for (auto &entry : deltas_)
+                    {
+                        if (entry.first.compare(0, topic.size(), topic) == 0)
+                        {
+                            entry.second.keyframe_requested = true;
+                        }
+                    }
+                    continue;
+                }
+
+                auto inserted = peers_.insert(std::make_pair(key, Peer()));
+                Peer &peer = inserted.first->second;
+                if (inserted.second)
+                {
+                    // 中途加入的订阅端从当前进度开始计算信用
+                    for (const auto &stream : streams_)
+                    {
+                        peer.acked[stream.first] = stream.second;
+                    }
+                }
+                peer.window = std::max<uint32_t>(1, packet.window);
+                peer.alive = true;
+                peer.last_seen = std::chrono::steady_clock::now();
+
+                if (packet.type == control::SUBSCRIBE)
+                {
+                    peer.topics.insert(topic);
+                }
+                else if (packet.type == control::UNSUBSCRIBE)
+                {
+                    auto it = peer.topics.find(topic);
+                    if (it != peer.topics.end())
+                    {
+                        peer.topics.erase(it);
+                    }
+                }
+                else if (packet.type == control::CREDIT && streams_.count(packet.stream_id))
+                {
+                    uint64_t &acked = peer.acked[packet.stream_id];
+                    acked = std::max(acked, packet.value);
+                }
+            }
+        }
+
+        // 等待所有订阅了该 Topic 的订阅端都有剩余信用
+        void wait_for_credit(const std::string &topic, uint64_t stream_id, uint64_t sequence)
+        {
+            const auto timeout = std::chrono::milliseconds(stream_options_.credit_timeout_ms);
+            // 先处理已到达的控制包，刷新各订阅端的 last_seen
+            handle_control(0);
+            const auto started = std::chrono::steady_clock::now();
+            while (true)
             {
-                zmq_msg_close(&data_msg);
-                return false;
+                const auto now = std::chrono::steady_clock::now();
+                bool blocked = false;
+                for (auto &entry : peers_)
+                {
+                    Peer &peer = entry.second;
+                    if (!peer.alive || !matches(peer, topic) || sequence < peer.acked[stream_id] + peer.window)
+                    {
+                        continue;
+                    }
+                    // 没有心跳，空闲的订阅端 last_seen 可能很早；从本次等待开始计时
+                    if (now - std::max(started, peer.last_seen) > timeout)
+                    {
+                        // 订阅端长时间无回应，在它再次发来消息之前不再等待
+                        peer.alive = false;
+                        continue;
+                    }
+                    blocked = true;
+                }
+                if (!blocked)
+                {
+                    return;
+                }
+                handle_control(10);
             }
+        }
 
-            const uint8_t *msg_data = static_cast<const uint8_t *>(zmq_msg_data(&data_msg));
-            size_t msg_size = zmq_msg_size(&data_msg);
-            data.assign(msg_data, msg_data + msg_size);
+        bool send_message(const std::string &topic, const envelope::Header *header, const void *data, size_t size,
+                          const std::string &metadata = std::string())
+        {
+            if (!send_prefix(topic, header, metadata))
+            {
+                return false;
+            }
 
-            zmq_msg_close(&data_msg);
+            // 再发送Data
+            if (resource_ && size >= pool_min_size_)
+            {
+                return send_pooled(data, size);
+            }
+            if (zmq_send(socket_, data, size, 0) == -1)
+            {
+                return false;
+            }
 
             return true;
         }
 
-        bool start_loop(MessageCallback callback)
+        bool send_prefix(const std::string &topic, const envelope::Header *header,
+                         const std::string &metadata = std::string())
         {
-            if (running_)
+            // 先发送Topic
+            if (zmq_send(socket_, topic.c_str(), topic.size(), ZMQ_SNDMORE) == -1)
             {
                 return false;
             }
 
-            running_ = true;
-            thread_ = std::thread([this, callback]()
-                                  {
-            while (running_) {
-                std::string topic;
-                std::vector<uint8_t> data;
-                
-                if (receive(topic, data, 100)) { // 100ms 超时以检查 running_ 标志
-                    callback(topic, data);
-                }
-            } });
-
-            return true;
+            // 扩展消息在 Topic 与 Data 之间插入 envelope
+            if (header == nullptr)
+            {
+                return true;
+            }
+            if (metadata.empty())
+            {
+                return zmq_send(socket_, header, sizeof(*header), ZMQ_SNDMORE) != -1;
+            }
+            // 元数据紧跟在 Header 之后，旧版本订阅端只读取 Header
+            envelope_scratch_.resize(sizeof(*header) + metadata.size());
+            std::memcpy(envelope_scratch_.data(), header, sizeof(*header));
+            std::memcpy(envelope_scratch_.data() + sizeof(*header), metadata.data(), metadata.size());
+            return zmq_send(socket_, envelope_scratch_.data(), envelope_scratch_.size(), ZMQ_SNDMORE) != -1;
         }
 
-        void stop_loop()
+        // 负载复制到从内存资源分配的块中，由 ZeroMQ 直接引用，发送完成后经回调归还
+        bool send_pooled(const void *data, size_t size)
         {
-            if (running_)
+            const size_t total = size + kPooledHeader;
+            uint8_t *block = static_cast<uint8_t *>(resource_->allocate(total));
+            std::memcpy(block, &total, sizeof(total));
+            std::memcpy(block + kPooledHeader, data, size);
+
+            zmq_msg_t msg;
+            std::shared_ptr<MemoryResource> *hint = new std::shared_ptr<MemoryResource>(resource_);
+            if (zmq_msg_init_data(&msg, block + kPooledHeader, size, release_pooled, hint) != 0)
             {
-                running_ = false;
-                if (thread_.joinable())
-                {
-                    thread_.join();
-                }
+                delete hint;
+                resource_->deallocate(block, total);
+                return false;
             }
+            if (zmq_msg_send(&msg, socket_, 0) == -1)
+            {
+                zmq_msg_close(&msg);
+                return false;
+            }
+            return true;
         }
 
-    private:
-        static std::string build_address(const std::string &endpoint, const Transport transport)
+        std::string build_address(const std::string &endpoint, Transport transport)
         {
             if (transport == Transport::IPC)
             {
@@ -274,48 +612,1176 @@ namespace zmq_simple
             }
         }
 
+        std::string endpoint_;
+        Transport transport_;
         bool owns_context_;
         void *context_;
         void *socket_;
-        std::atomic<bool> running_;
-        std::thread thread_;
+        bool compress_;
+        CompressionOptions compression_;
+        uint32_t dict_id_;
+        std::vector<uint8_t> scratch_;
+        std::vector<uint8_t> envelope_scratch_;
+        void *control_;
+        StreamOptions stream_options_;
+        uint64_t stream_base_;
+        uint64_t stream_counter_;
+        std::map<uint64_t, uint64_t> streams_; // 流 ID -> 已发送块数
+        std::map<std::string, Peer> peers_;
+        std::unique_ptr<fd_channel::Server> fd_server_;
+        size_t memfd_threshold_ = 0;
+        std::shared_ptr<MemoryResource> resource_;
+        size_t pool_min_size_ = 0;
+        bool delta_ = false;
+        DeltaOptions delta_options_;
+        std::map<std::string, DeltaState> deltas_;
+        std::vector<uint8_t> delta_scratch_;
     };
 
-    Subscriber::Subscriber(const std::string &endpoint, Transport transport)
-        : pimpl_(std::make_unique<Impl>(endpoint, transport))
-    {
-    }
-
-    Subscriber::Subscriber(const std::string &endpoint, Transport transport, Context &shared_context)
-        : pimpl_(std::make_unique<Impl>(endpoint, transport, shared_context.get_raw_context()))
+    class Publisher::Stream::Impl
     {
-    }
+    public:
+        Impl(Publisher::Impl *publisher, const std::string &topic, uint64_t stream_id)
+            : publisher_(publisher), topic_(topic), stream_id_(stream_id),
+              chunk_size_(publisher->chunk_size()), closed_(false)
+        {
+            buffer_.reserve(chunk_size_);
+        }
 
-    Subscriber::~Subscriber() = default;
+        bool write(const uint8_t *data, size_t size)
+        {
+            if (closed_)
+            {
+                return false;
+            }
 
-    bool Subscriber::subscribe(const std::string &topic)
-    {
-        return pimpl_->subscribe(topic);
-    }
+            while (size > 0)
+            {
+                // 缓冲区为空且剩余数据足够一整块时直接发送，避免复制
+                if (buffer_.empty() && size >= chunk_size_)
+                {
+                    if (!publisher_->send_chunk(topic_, stream_id_, data, chunk_size_, false))
+                    {
+                        return false;
+                    }
+                    data += chunk_size_;
+                    size -= chunk_size_;
+                    continue;
+                }
 
-    bool Subscriber::unsubscribe(const std::string &topic)
-    {
-        return pimpl_->unsubscribe(topic);
-    }
+                const size_t take = std::min(chunk_size_ - buffer_.size(), size);
+                buffer_.insert(buffer_.end(), data, data + take);
+                data += take;
+                size -= take;
+
+                if (buffer_.size() == chunk_size_)
+                {
+                    const bool ok = publisher_->send_chunk(topic_, stream_id_, buffer_.data(), buffer_.size(), false);
+                    buffer_.clear();
+                    if (!ok)
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        bool close()
+        {
+            if (closed_)
+            {
+                return true;
+            }
+            closed_ = true;
+            return publisher_->send_chunk(topic_, stream_id_, buffer_.data(), buffer_.size(), true);
+        }
+
+    private:
+        Publisher::Impl *publisher_;
+        std::string topic_;
+        uint64_t stream_id_;
+        size_t chunk_size_;
+        bool closed_;
+        std::vector<uint8_t> buffer_;
+    };
+
+    Publisher::Stream::Stream(std::unique_ptr<Impl> impl)
+        : pimpl_(std::move(impl))
+    {
+    }
+
+    Publisher::Stream::Stream(Stream &&other) noexcept = default;
+
+    Publisher::Stream &Publisher::Stream::operator=(Stream &&other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            pimpl_ = std::move(other.pimpl_);
+        }
+        return *this;
+    }
+
+    Publisher::Stream::~Stream()
+    {
+        close();
+    }
+
+    bool Publisher::Stream::write(const void *data, size_t size)
+    {
+        return pimpl_ && pimpl_->write(static_cast<const uint8_t *>(data), size);
+    }
+
+    bool Publisher::Stream::write(const std::string &data)
+    {
+        return write(data.data(), data.size());
+    }
+
+    bool Publisher::Stream::close()
+    {
+        return pimpl_ && pimpl_->close();
+    }
+
+    Publisher::Publisher(const std::string &endpoint, Transport transport)
+        : pimpl_(std::make_unique<Impl>(endpoint, transport))
+    {
+    }
+
+    Publisher::Publisher(const std::string &endpoint, Transport transport, Context &shared_context)
+        : pimpl_(std::make_unique<Impl>(endpoint, transport, shared_context.get_raw_context()))
+    {
+    }
+
+    Publisher::~Publisher() = default;
+
+    bool Publisher::publish(const std::string &topic, const std::string &data)
+    {
+        return pimpl_->publish(topic, data.c_str(), data.size(), ContentType::Raw);
+    }
+
+    bool Publisher::publish(const std::string &topic, const void *data, size_t size)
+    {
+        return pimpl_->publish(topic, data, size, ContentType::Raw);
+    }
+
+    bool Publisher::publish(const std::string &topic, const void *data, size_t size, ContentType content_type)
+    {
+        return pimpl_->publish(topic, data, size, content_type);
+    }
+
+    bool Publisher::publish_shared(const std::string &topic, const void *data, size_t size,
+                                   std::shared_ptr<void> holder, ContentType content_type, const std::string &metadata)
+    {
+        return pimpl_->publish_shared(topic, data, size, std::move(holder), content_type, metadata);
+    }
+
+    void Publisher::set_compression(const CompressionOptions &options)
+    {
+        pimpl_->set_compression(options);
+    }
+
+    void Publisher::disable_compression()
+    {
+        pimpl_->disable_compression();
+    }
+
+    void Publisher::enable_streaming(const StreamOptions &options)
+    {
+        pimpl_->enable_streaming(options);
+    }
+
+    void Publisher::enable_memfd(size_t threshold)
+    {
+        pimpl_->enable_memfd(threshold);
+    }
+
+    void Publisher::set_memory_resource(std::shared_ptr<MemoryResource> resource, size_t min_size)
+    {
+        pimpl_->set_memory_resource(std::move(resource), min_size);
+    }
+
+    void Publisher::enable_delta(const DeltaOptions &options)
+    {
+        pimpl_->enable_delta(options);
+    }
+
+    Publisher::Stream Publisher::open_stream(const std::string &topic)
+    {
+        const uint64_t stream_id = pimpl_->begin_stream();
+        return Stream(std::unique_ptr<Stream::Impl>(new Stream::Impl(pimpl_.get(), topic, stream_id)));
+    }
+
+    class Subscriber::Impl
+    {
+    public:
+        Impl(const std::string &endpoint, Transport transport)
+            : owns_context_(true), running_(false), endpoint_(endpoint), transport_(transport),
+              dict_id_(0), control_(nullptr), timeout_ms_(-1)
+        {
+            context_ = zmq_ctx_new();
+            socket_ = zmq_socket(context_, ZMQ_SUB);
+
+            const std::string addr = build_address(endpoint, transport);
+
+            if (zmq_connect(socket_, addr.c_str()) != 0)
+            {
+                throw std::runtime_error("Failed to connect subscriber: " + std::string(zmq_strerror(zmq_errno())));
+            }
+        }
+
+        Impl(const std::string &endpoint, Transport transport, void *shared_context)
+            : owns_context_(false), context_(shared_context), running_(false), endpoint_(endpoint),
+              transport_(transport), dict_id_(0), control_(nullptr), timeout_ms_(-1)
+        {
+            socket_ = zmq_socket(context_, ZMQ_SUB);
+
+            std::string addr = build_address(endpoint, transport);
+
+            if (zmq_connect(socket_, addr.c_str()) != 0)
+            {
+                throw std::runtime_error("Failed to connect subscriber: " + std::string(zmq_strerror(zmq_errno())));
+            }
+        }
+
+        ~Impl()
+        {
+            stop_loop();
+
+            if (control_)
+            {
+                send_control(control::BYE, 0, 0, std::string());
+                zmq_close(control_);
+            }
+            if (socket_)
+            {
+                zmq_close(socket_);
+            }
+            if (context_ && owns_context_)
+            {
+                zmq_ctx_destroy(context_);
+            }
+        }
+
+        bool subscribe(const std::string &topic)
+        {
+            if (zmq_setsockopt(socket_, ZMQ_SUBSCRIBE, topic.c_str(), topic.size()) != 0)
+            {
+                return false;
+            }
+            topics_.insert(topic);
+            if (control_)
+            {
+                send_control(control::SUBSCRIBE, 0, 0, topic);
+            }
+            if (delta_)
+            {
+                send_control(control::KEYFRAME, 0, 0, topic);
+            }
+            if (fd_client_)
+            {
+                fd_client_->subscribe(topic);
+            }
+            return true;
+        }
+
+        bool unsubscribe(const std::string &topic)
+        {
+            if (zmq_setsockopt(socket_, ZMQ_UNSUBSCRIBE, topic.c_str(), topic.size()) != 0)
+            {
+                return false;
+            }
+            auto it = topics_.find(topic);
+            if (it != topics_.end())
+            {
+                topics_.erase(it);
+            }
+            if (control_)
+            {
+                send_control(control::UNSUBSCRIBE, 0, 0, topic);
+            }
+            if (fd_client_)
+            {
+                fd_client_->unsubscribe(topic);
+            }
+            return true;
+        }
+
+        void set_compression_dictionary(const std::vector<uint8_t> &dictionary)
+        {
+            dictionary_ = dictionary;
+            if (dictionary_.size() > lz4::kMaxDictionarySize)
+            {
+                dictionary_.erase(dictionary_.begin(), dictionary_.end() - lz4::kMaxDictionarySize);
+            }
+            dict_id_ = dictionary_id(dictionary_);
+        }
+
+        void enable_streaming(const StreamOptions &options)
+        {
+            stream_options_ = options;
+            if (stream_options_.window == 0)
+            {
+                stream_options_.window = 1;
+            }
+            open_control();
+        }
+
+        void set_chunk_callback(ChunkCallback callback)
+        {
+            chunk_callback_ = callback;
+        }
+
+        void enable_memfd()
+        {
+            if (transport_ != Transport::IPC)
+            {
+                throw std::runtime_error("memfd payload handoff requires IPC transport");
+            }
+            if (fd_client_)
+            {
+                return;
+            }
+            fd_client_.reset(new fd_channel::Client(memfd_path(endpoint_)));
+            for (const std::string &topic : topics_)
+            {
+                fd_client_->subscribe(topic);
+            }
+        }
+
+        uint64_t memfd_dropped() const
+        {
+            return memfd_dropped_.load();
+        }
+
+        void set_memory_resource(std::shared_ptr<MemoryResource> resource)
+        {
+            resource_ = std::move(resource);
+        }
+
+        void enable_delta()
+        {
+            open_control();
+            if (!delta_)
+            {
+                delta_ = true;
+                for (const std::string &topic : topics_)
+                {
+                    send_control(control::KEYFRAME, 0, 0, topic);
+                }
+            }
+        }
+
+        bool add_filter(const std::string &expression)
+        {
+            ContentFilter filter;
+            if (!ContentFilter::parse(expression, filter))
+            {
+                return false;
+            }
+            filters_.push_back(std::move(filter));
+            return true;
+        }
+
+        void clear_filters()
+        {
+            filters_.clear();
+        }
+
+        bool receive(std::string &topic, std::vector<uint8_t> &data, int timeout_ms)
+        {
+            Message message;
+            if (!receive(message, timeout_ms))
+            {
+                return false;
+            }
+            topic = message.topic();
+            data.assign(message.data(), message.data() + message.size());
+            return true;
+        }
+
+        bool receive(Message &message, int timeout_ms)
+        {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+            int remaining = timeout_ms;
+
+            // 数据块、无法解码或未通过过滤的消息不会交付，继续等待直到超时
+            while (true)
+            {
+                const Result result = receive_one(message, remaining);
+                if (result == Result::Timeout)
+                {
+                    return false;
+                }
+                if (result == Result::Delivered && accept(message))
+                {
+                    return true;
+                }
+                if (timeout_ms >= 0)
+                {
+                    const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        deadline - std::chrono::steady_clock::now());
+                    if (left.count() <= 0)
+                    {
+                        return false;
+                    }
+                    remaining = static_cast<int>(left.count());
+                }
+            }
+        }
+
+        bool start_loop(MessageCallback callback)
+        {
+            if (running_)
+            {
+                return false;
+            }
+
+            running_ = true;
+            thread_ = std::thread([this, callback]()
+                                  {
+            // 缓冲区在循环外复用，避免每条消息重新分配
+            std::string topic;
+            std::vector<uint8_t> data;
+            while (running_) {
+                if (receive(topic, data, 100)) { // 100ms 超时以检查 running_ 标志
+                    callback(topic, data);
+                }
+            } });
+
+            return true;
+        }
+
+        bool start_message_loop(MessageViewCallback callback)
+        {
+            if (running_)
+            {
+                return false;
+            }
+
+            running_ = true;
+            thread_ = std::thread([this, callback]()
+                                  {
+            while (running_) {
+                Message message;
+                if (receive(message, 100)) { // 100ms 超时以检查 running_ 标志
+                    callback(message);
+                }
+            } });
+
+            return true;
+        }
+
+        void *socket() const
+        {
+            return socket_;
+        }
+
+        int fd() const
+        {
+            int fd = -1;
+            size_t size = sizeof(fd);
+            if (zmq_getsockopt(socket_, ZMQ_FD, &fd, &size) != 0)
+            {
+                return -1;
+            }
+            return fd;
+        }
+
+        bool readable() const
+        {
+            int events = 0;
+            size_t size = sizeof(events);
+            return zmq_getsockopt(socket_, ZMQ_EVENTS, &events, &size) == 0 && (events & ZMQ_POLLIN) != 0;
+        }
+
+        bool start_batch_loop(BatchCallback callback, const BatchOptions &options)
+        {
+            if (running_)
+            {
+                return false;
+            }
+
+            running_ = true;
+            const size_t max_batch = std::max<size_t>(1, options.max_batch);
+            const auto max_delay = std::chrono::milliseconds(std::max(0, options.max_delay_ms));
+            thread_ = std::thread([this, callback, max_batch, max_delay]()
+                                  {
+            std::vector<Message> batch;
+            batch.reserve(max_batch);
+            while (running_) {
+                Message message;
+                if (!receive(message, 100)) { // 100ms 超时以检查 running_ 标志
+                    continue;
+                }
+                batch.push_back(std::move(message));
+
+                // 第一条消息到达后，在时间窗口内继续收满一批；窗口为 0 时只取已到达的消息
+                const auto deadline = std::chrono::steady_clock::now() + max_delay;
+                while (batch.size() < max_batch) {
+                    const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        deadline - std::chrono::steady_clock::now());
+                    if (!receive(message, std::max<int>(0, static_cast<int>(left.count())))) {
+                        break;
+                    }
+                    batch.push_back(std::move(message));
+                }
+                callback(batch);
+                batch.clear();
+            } });
+
+            return true;
+        }
+
+        void stop_loop()
+        {
+            if (running_)
+            {
+                running_ = false;
+                if (thread_.joinable())
+                {
+                    thread_.join();
+                }
+            }
+        }
+
+    private:
+        enum class Result
+        {
+            Delivered, // 得到一条完整消息
+            Consumed,  // 收到消息但没有可交付的内容
+            Timeout,
+        };
+
+        struct Assembly
+        {
+            uint64_t next_sequence = 0;
+            std::vector<uint8_t> data;
+        };
+
+        // 差分 Topic 的最新版本
+        struct DeltaBase
+        {
+            uint64_t chain = 0;
+            uint64_t version = 0;
+            Message message;
+            std::shared_ptr<std::vector<uint8_t>> buffer; // 由差分还原时 message 引用的缓冲区
+            std::shared_ptr<std::vector<uint8_t>> spare;  // 上一个缓冲区，不再被引用时复用
+        };
+
+        void open_control()
+        {
+            if (control_ != nullptr)
+            {
+                return;
+            }
+
+            control_ = zmq_socket(context_, ZMQ_DEALER);
+            int linger = 100;
+            zmq_setsockopt(control_, ZMQ_LINGER, &linger, sizeof(linger));
+            const std::string addr = build_address(endpoint_ + "_ctl", transport_);
+            if (zmq_connect(control_, addr.c_str()) != 0)
+            {
+                const std::string error = zmq_strerror(zmq_errno());
+                zmq_close(control_);
+                control_ = nullptr;
+                throw std::runtime_error("Failed to connect control channel: " + error);
+            }
+
+            // 告知发布端已有的订阅，发布端只等待订阅了对应 Topic 的订阅端
+            for (const std::string &topic : topics_)
+            {
+                send_control(control::SUBSCRIBE, 0, 0, topic);
+            }
+        }
+
+        Result receive_one(Message &message, int timeout_ms)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            if (timeout_ms != timeout_ms_)
+            {
+                zmq_setsockopt(socket_, ZMQ_RCVTIMEO, &timeout_ms, sizeof(timeout_ms));
+                timeout_ms_ = timeout_ms;
+            }
+
+            // 接收Topic
+            zmq_msg_t topic_msg;
+            zmq_msg_init(&topic_msg);
+
+            int rc = zmq_msg_recv(&topic_msg, socket_, 0);
+            if (rc == -1)
+            {
+                zmq_msg_close(&topic_msg);
+                return Result::Timeout;
+            }
+
+            std::string topic(static_cast<const char *>(zmq_msg_data(&topic_msg)), zmq_msg_size(&topic_msg));
+            zmq_msg_close(&topic_msg);
+
+            // 接收Data，消息对象交给 Message 持有，避免复制
+            std::shared_ptr<zmq_msg_t> data_msg(new zmq_msg_t, [](zmq_msg_t *msg)
+                                                { zmq_msg_close(msg); delete msg; });
+            zmq_msg_init(data_msg.get());
+
+            rc = zmq_msg_recv(data_msg.get(), socket_, 0);
+            if (rc == -1)
+            {
+                return Result::Timeout;
+            }
+
+            // 三帧消息: 第二帧为 envelope，第三帧才是 Data
+            envelope::Header header;
+            bool extended = false;
+            std::string metadata;
+            if (zmq_msg_more(data_msg.get()))
+            {
+                extended = true;
+                const bool valid = envelope::parse_header(zmq_msg_data(data_msg.get()), zmq_msg_size(data_msg.get()), header);
+                if (valid && zmq_msg_size(data_msg.get()) > sizeof(header))
+                {
+                    // Header 之后为发布端附带的元数据
+                    metadata.assign(static_cast<const char *>(zmq_msg_data(data_msg.get())) + sizeof(header),
+                                    zmq_msg_size(data_msg.get()) - sizeof(header));
+                }
+
+                rc = zmq_msg_recv(data_msg.get(), socket_, 0);
+                if (rc == -1 || !valid)
+                {
+                    drain(*data_msg);
+                    return Result::Consumed;
+                }
+                drain(*data_msg);
+            }
+
+            const uint8_t *msg_data = static_cast<const uint8_t *>(zmq_msg_data(data_msg.get()));
+            size_t msg_size = zmq_msg_size(data_msg.get());
+            if (!extended)
+            {
+                message = Message(std::move(topic), msg_data, msg_size, data_msg);
+                return Result::Delivered;
+            }
+            if (header.flags & envelope::FLAG_STREAM_CHUNK)
+            {
+                return handle_chunk(topic, header, msg_data, msg_size, message);
+            }
+            if (header.flags & (envelope::FLAG_DELTA | envelope::FLAG_KEYFRAME))
+            {
+                return apply_delta(topic, header, data_msg, message);
+            }
+
+            Result result = Result::Consumed;
+            if (header.flags & envelope::FLAG_MEMFD)
+            {
+                // 等待描述符的时间不超过本次接收剩余的超时，receive(message, 0) 不阻塞
+                int wait_ms = kMemfdWaitMs;
+                if (timeout_ms >= 0)
+                {
+                    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - start);
+                    wait_ms = static_cast<int>(std::max<int64_t>(
+                        0, std::min<int64_t>(kMemfdWaitMs, timeout_ms - elapsed.count())));
+                }
+                result = map_memfd(topic, header, msg_data, msg_size, message, wait_ms);
+            }
+            else if (decode_payload(topic, header, data_msg, message))
+            {
+                result = Result::Delivered;
+            }
+            if (result == Result::Delivered && !metadata.empty())
+            {
+                message.set_metadata(std::move(metadata));
+            }
+            return result;
+        }
+
+        Result map_memfd(std::string &topic, const envelope::Header &header, const uint8_t *payload, size_t size,
+                         Message &message, int wait_ms)
+        {
+            envelope::MemfdRef ref;
+            if (!fd_client_ || size != sizeof(ref))
+            {
+                // 未开启 enable_memfd 的订阅端无法读取描述符
+                ++memfd_dropped_;
+                return Result::Consumed;
+            }
+            std::memcpy(&ref, payload, sizeof(ref));
+
+            // 描述符先于 ZeroMQ 消息发出，通常已在套接字中等待
+            const uint8_t *data = nullptr;
+            std::shared_ptr<void> mapping = fd_client_->map(ref.token, ref.size, data, wait_ms);
+            if (!mapping)
+            {
+                ++memfd_dropped_;
+                return Result::Consumed;
+            }
+            message = Message(std::move(topic), data, static_cast<size_t>(ref.size), std::move(mapping),
+                              static_cast<ContentType>(header.content_type));
+            return Result::Delivered;
+        }
+
+        Result handle_chunk(std::string &topic, const envelope::Header &header,
+                            const uint8_t *payload, size_t size, Message &message)
+        {
+            const bool last = (header.flags & envelope::FLAG_STREAM_END) != 0;
+            Result result = Result::Consumed;
+
+            auto it = assemblies_.find(header.stream_id);
+            if (header.sequence == 0)
+            {
+                if (assemblies_.size() >= kMaxAssemblies)
+                {
+                    assemblies_.erase(assemblies_.begin());
+                }
+                it = assemblies_.insert(std::make_pair(header.stream_id, Assembly())).first;
+            }
+
+            // 中途加入或丢失块的流直接放弃，只回馈信用
+            if (it != assemblies_.end() && it->second.next_sequence != header.sequence)
+            {
+                assemblies_.erase(it);
+                it = assemblies_.end();
+            }
+
+            if (it != assemblies_.end())
+            {
+                Assembly &assembly = it->second;
+                ++assembly.next_sequence;
+
+                if (chunk_callback_)
+                {
+                    chunk_callback_(topic, header.stream_id, payload, size, last);
+                }
+                else if (assembly.data.size() + size > stream_options_.max_stream_size)
+                {
+                    assemblies_.erase(it);
+                    it = assemblies_.end();
+                }
+                else
+                {
+                    assembly.data.insert(assembly.data.end(), payload, payload + size);
+                    if (last)
+                    {
+                        auto buffer = std::make_shared<std::vector<uint8_t>>(std::move(assembly.data));
+                        message = Message(std::move(topic), buffer->data(), buffer->size(), buffer);
+                        result = Result::Delivered;
+                    }
+                }
+
+                if (last && it != assemblies_.end())
+                {
+                    assemblies_.erase(it);
+                }
+            }
+
+            // 每消费半个窗口回馈一次信用
+            const uint64_t consumed = header.sequence + 1;
+            const uint64_t batch = std::max<uint64_t>(1, stream_options_.window / 2);
+            if (control_ && (last || consumed % batch == 0))
+            {
+                send_control(control::CREDIT, header.stream_id, consumed, std::string());
+            }
+            return result;
+        }
+
+        Result apply_delta(std::string &topic, const envelope::Header &header,
+                           const std::shared_ptr<zmq_msg_t> &data_msg, Message &message)
+        {
+            if (header.flags & envelope::FLAG_KEYFRAME)
+            {
+                const std::string key = topic;
+                if (!decode_payload(topic, header, data_msg, message))
+                {
+                    return Result::Consumed;
+                }
+                DeltaBase &base = bases_[key];
+                base.chain = header.stream_id;
+                base.version = header.sequence;
+                base.message = message;
+                base.buffer.reset();
+                keyframe_requests_.erase(key);
+                return Result::Delivered;
+            }
+
+            auto it = bases_.find(topic);
+            if (it == bases_.end() || it->second.chain != header.stream_id || it->second.version + 1 != header.sequence)
+            {
+                // 中途加入或丢失了版本，等待完整版本
+                if (it != bases_.end())
+                {
+                    bases_.erase(it);
+                }
+                request_keyframe(topic);
+                return Result::Consumed;
+            }
+
+            DeltaBase &base = it->second;
+            const uint8_t *patch = static_cast<const uint8_t *>(zmq_msg_data(data_msg.get()));
+            const size_t patch_size = zmq_msg_size(data_msg.get());
+            std::shared_ptr<std::vector<uint8_t>> buffer = base.spare;
+            if (!buffer || buffer.use_count() > 2)
+            {
+                buffer = std::make_shared<std::vector<uint8_t>>();
+            }
+            buffer->resize(header.raw_size);
+            if (!delta::apply(base.message.data(), base.message.size(), patch, patch_size, buffer->data(), buffer->size()))
+            {
+                bases_.erase(it);
+                request_keyframe(topic);
+                return Result::Consumed;
+            }
+
+            message = Message(std::move(topic), buffer->data(), buffer->size(), buffer,
+                              static_cast<ContentType>(header.content_type));
+            base.version = header.sequence;
+            base.message = message;
+            base.spare = std::move(base.buffer);
+            base.buffer = std::move(buffer);
+            return Result::Delivered;
+        }
+
+        // 同一 Topic 的请求间隔至少 kKeyframeRetryMs，避免版本缺失期间每条差分都发请求
+        void request_keyframe(const std::string &topic)
+        {
+            if (!delta_ || control_ == nullptr)
+            {
+                return;
+            }
+            const auto now = std::chrono::steady_clock::now();
+            auto it = keyframe_requests_.find(topic);
+            if (it != keyframe_requests_.end() && now - it->second < std::chrono::milliseconds(kKeyframeRetryMs))
+            {
+                return;
+            }
+            keyframe_requests_[topic] = now;
+            send_control(control::KEYFRAME, 0, 0, topic);
+        }
+
+        // 过滤条件在 JSON 文本、CBOR 与 MessagePack 负载上求值，其他编码无法求值，设置了条件时不交付
+        bool accept(const Message &message) const
+        {
+            for (const ContentFilter &filter : filters_)
+            {
+                if (!filter.matches(message.content_type(), message.data(), message.size()))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void send_control(uint8_t type, uint64_t stream_id, uint64_t value, const std::string &topic)
+        {
+            control::Packet packet;
+            std::memset(&packet, 0, sizeof(packet));
+            packet.type = type;
+            packet.window = stream_options_.window;
+            packet.stream_id = stream_id;
+            packet.value = value;
+
+            std::vector<uint8_t> frame(sizeof(packet) + topic.size());
+            std::memcpy(frame.data(), &packet, sizeof(packet));
+            std::memcpy(frame.data() + sizeof(packet), topic.data(), topic.size());
+            zmq_send(control_, frame.data(), frame.size(), ZMQ_DONTWAIT);
+        }
+
+        // 丢弃多余的帧，保证下次接收从新消息的 Topic 开始
+        void drain(zmq_msg_t &msg)
+        {
+            while (zmq_msg_more(&msg))
+            {
+                if (zmq_msg_recv(&msg, socket_, 0) == -1)
+                {
+                    break;
+                }
+            }
+        }
+
+        bool decode_payload(std::string &topic, const envelope::Header &header,
+                            const std::shared_ptr<zmq_msg_t> &data_msg, Message &message)
+        {
+            const uint8_t *payload = static_cast<const uint8_t *>(zmq_msg_data(data_msg.get()));
+            const size_t size = zmq_msg_size(data_msg.get());
+            const ContentType content_type = static_cast<ContentType>(header.content_type);
+
+            if (header.flags & envelope::FLAG_COMPRESSED)
+            {
+                if (header.dict_id != 0 && header.dict_id != dict_id_)
+                {
+                    return false; // 字典不一致，无法解压
+                }
+                std::shared_ptr<uint8_t> buffer = new_buffer(header.raw_size);
+                const uint8_t *dict = header.dict_id != 0 ? dictionary_.data() : nullptr;
+                if (!lz4::decompress(payload, size, buffer.get(), header.raw_size, dict, dictionary_.size()))
+                {
+                    return false;
+                }
+                message = Message(std::move(topic), buffer.get(), header.raw_size, buffer, content_type);
+                return true;
+            }
+
+            message = Message(std::move(topic), payload, size, data_msg, content_type);
+            return true;
+        }
+
+        // 解码缓冲区: 设置了内存资源时从中分配，最后一个引用释放时归还
+        std::shared_ptr<uint8_t> new_buffer(size_t size)
+        {
+            if (!resource_)
+            {
+                auto buffer = std::make_shared<std::vector<uint8_t>>(size);
+                return std::shared_ptr<uint8_t>(buffer, buffer->data());
+            }
+            std::shared_ptr<MemoryResource> resource = resource_;
+            uint8_t *p = static_cast<uint8_t *>(resource->allocate(size));
+            return std::shared_ptr<uint8_t>(p, [resource, size](uint8_t *q)
+                                            { resource->deallocate(q, size); });
+        }
+
+        static std::string build_address(const std::string &endpoint, const Transport transport)
+        {
+            if (transport == Transport::IPC)
+            {
+                return "ipc:///tmp/docker_share/" + endpoint + ".ipc";
+            }
+            else
+            {
+                return "inproc://" + endpoint;
+            }
+        }
+
+        bool owns_context_;
+        void *context_;
+        void *socket_;
+        std::atomic<bool> running_;
+        std::thread thread_;
+        static const size_t kMaxAssemblies = 64;
+        static const int kMemfdWaitMs = 1000; // 无超时的接收等待描述符的上限
+        static const int kKeyframeRetryMs = 200;
+
+        std::string endpoint_;
+        Transport transport_;
+        std::vector<uint8_t> dictionary_;
+        uint32_t dict_id_;
+        std::multiset<std::string> topics_;
+        void *control_;
+        StreamOptions stream_options_;
+        ChunkCallback chunk_callback_;
+        std::map<uint64_t, Assembly> assemblies_;
+        int timeout_ms_;
+        std::unique_ptr<fd_channel::Client> fd_client_;
+        std::atomic<uint64_t> memfd_dropped_{0}; // 接收线程累加，可在其他线程读取
+        std::vector<ContentFilter> filters_;
+        std::shared_ptr<MemoryResource> resource_;
+        bool delta_ = false;
+        std::map<std::string, DeltaBase> bases_;
+        std::map<std::string, std::chrono::steady_clock::time_point> keyframe_requests_;
+    };
+
+    Subscriber::Subscriber(const std::string &endpoint, Transport transport)
+        : pimpl_(std::make_unique<Impl>(endpoint, transport))
+    {
+    }
+
+    Subscriber::Subscriber(const std::string &endpoint, Transport transport, Context &shared_context)
+        : pimpl_(std::make_unique<Impl>(endpoint, transport, shared_context.get_raw_context()))
+    {
+    }
+
+    Subscriber::~Subscriber() = default;
+
+    bool Subscriber::subscribe(const std::string &topic)
+    {
+        return pimpl_->subscribe(topic);
+    }
+
+    bool Subscriber::unsubscribe(const std::string &topic)
+    {
+        return pimpl_->unsubscribe(topic);
+    }
+
+    void Subscriber::set_compression_dictionary(const std::vector<uint8_t> &dictionary)
+    {
+        pimpl_->set_compression_dictionary(dictionary);
+    }
+
+    void Subscriber::enable_streaming(const StreamOptions &options)
+    {
+        pimpl_->enable_streaming(options);
+    }
+
+    void Subscriber::set_chunk_callback(ChunkCallback callback)
+    {
+        pimpl_->set_chunk_callback(callback);
+    }
+
+    void Subscriber::enable_memfd()
+    {
+        pimpl_->enable_memfd();
+    }
+
+    uint64_t Subscriber::memfd_dropped() const
+    {
+        return pimpl_->memfd_dropped();
+    }
+
+    void Subscriber::set_memory_resource(std::shared_ptr<MemoryResource> resource)
+    {
+        pimpl_->set_memory_resource(std::move(resource));
+    }
+
+    void Subscriber::enable_delta()
+    {
+        pimpl_->enable_delta();
+    }
+
+    bool Subscriber::add_filter(const std::string &expression)
+    {
+        return pimpl_->add_filter(expression);
+    }
+
+    void Subscriber::clear_filters()
+    {
+        pimpl_->clear_filters();
+    }
 
     bool Subscriber::receive(std::string &topic, std::vector<uint8_t> &data, int timeout_ms)
     {
         return pimpl_->receive(topic, data, timeout_ms);
     }
 
+    bool Subscriber::receive(Message &message, int timeout_ms)
+    {
+        return pimpl_->receive(message, timeout_ms);
+    }
+
     bool Subscriber::start_loop(MessageCallback callback)
     {
         return pimpl_->start_loop(callback);
     }
 
+    bool Subscriber::start_message_loop(MessageViewCallback callback)
+    {
+        return pimpl_->start_message_loop(callback);
+    }
+
+    int Subscriber::fd() const
+    {
+        return pimpl_->fd();
+    }
+
+    bool Subscriber::readable() const
+    {
+        return pimpl_->readable();
+    }
+
+    bool Subscriber::start_batch_loop(BatchCallback callback, const BatchOptions &options)
+    {
+        return pimpl_->start_batch_loop(callback, options);
+    }
+
     void Subscriber::stop_loop()
     {
         pimpl_->stop_loop();
     }
 
+    class Poller::Impl
+    {
+    public:
+        size_t add(Subscriber &subscriber, void *socket)
+        {
+            for (size_t i = 0; i < subscribers_.size(); ++i)
+            {
+                if (subscribers_[i] == &subscriber)
+                {
+                    return i;
+                }
+            }
+            subscribers_.push_back(&subscriber);
+            zmq_pollitem_t item = {socket, 0, ZMQ_POLLIN, 0};
+            items_.push_back(item);
+            return subscribers_.size() - 1;
+        }
+
+        bool remove(Subscriber &subscriber)
+        {
+            for (size_t i = 0; i < subscribers_.size(); ++i)
+            {
+                if (subscribers_[i] == &subscriber)
+                {
+                    subscribers_.erase(subscribers_.begin() + i);
+                    items_.erase(items_.begin() + i);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool wait(std::vector<size_t> &ready, int timeout_ms)
+        {
+            ready.clear();
+            if (items_.empty())
+            {
+                return false;
+            }
+            if (zmq_poll(items_.data(), static_cast<int>(items_.size()), timeout_ms) <= 0)
+            {
+                return false;
+            }
+            for (size_t i = 0; i < items_.size(); ++i)
+            {
+                if (items_[i].revents & ZMQ_POLLIN)
+                {
+                    ready.push_back(i);
+                }
+            }
+            return !ready.empty();
+        }
+
+        Subscriber &at(size_t index) const
+        {
+            return *subscribers_.at(index);
+        }
+
+        size_t size() const
+        {
+            return subscribers_.size();
+        }
+
+    private:
+        std::vector<Subscriber *> subscribers_;
+        std::vector<zmq_pollitem_t> items_;
+    };
+
+    Poller::Poller()
+        : pimpl_(std::make_unique<Impl>())
+    {
+    }
+
+    Poller::~Poller() = default;
+
+    size_t Poller::add(Subscriber &subscriber)
+    {
+        return pimpl_->add(subscriber, subscriber.pimpl_->socket());
+    }
+
+    bool Poller::remove(Subscriber &subscriber)
+    {
+        return pimpl_->remove(subscriber);
+    }
+
+    bool Poller::wait(std::vector<size_t> &ready, int timeout_ms)
+    {
+        return pimpl_->wait(ready, timeout_ms);
+    }
+
+    Subscriber &Poller::at(size_t index) const
+    {
+        return pimpl_->at(index);
+    }
+
+    size_t Poller::size() const
+    {
+        return pimpl_->size();
+    }
+
 } // namespace zmq_simple